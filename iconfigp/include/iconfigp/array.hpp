@@ -5,6 +5,7 @@
 #define ICONFIGP_ARRAY_HPP_INCLUDED
 
 #include "iconfigp/exception.hpp"
+#include "iconfigp/expected.hpp"
 #include "iconfigp/value-parser.hpp"
 
 #include <algorithm>
@@ -15,8 +16,9 @@
 
 namespace iconfigp {
 
+// same as parse_as_array, but reports the failed range instead of throwing
 template<typename T, size_t Size>
-[[nodiscard]] std::array<T, Size> parse_as_array(
+[[nodiscard]] expected<std::array<T, Size>, range_error> try_parse_as_array(
     std::string_view input,
     std::string_view delim = ":,"
 ) {
@@ -29,14 +31,13 @@ template<typename T, size_t Size>
     auto str = input.substr(position, input.find_first_of(delim, position) - position);
 
     if (str.empty()) {
-      throw value_parse_exception::range_exception{"expected value", position};
+      return unexpected{range_error{"expected value", position}};
     }
 
     if (auto value = value_parser<T>::parse(str)) {
       *it = *value;
     } else {
-      throw value_parse_exception::range_exception{"unable to parse item",
-        position, str.size()};
+      return unexpected{range_error{"unable to parse item", position, str.size()}};
     }
 
     position += str.size() + 1;
@@ -45,15 +46,29 @@ template<typename T, size_t Size>
   if (Size > 1 && it == buffer.begin() + 1) {
     std::ranges::fill(buffer, buffer[0]);
   } else if (it != buffer.end()) {
-    throw value_parse_exception::range_exception{"expected more items", input.size()};
+    return unexpected{range_error{"expected more items", input.size()}};
   } else if (position < input.size()) {
-    throw value_parse_exception::range_exception{"found excess items", position,
-      input.size() - position};
+    return unexpected{range_error{"found excess items", position,
+      input.size() - position}};
   }
 
   return buffer;
 }
 
+
+
+template<typename T, size_t Size>
+[[nodiscard]] std::array<T, Size> parse_as_array(
+    std::string_view input,
+    std::string_view delim = ":,"
+) {
+  auto result = try_parse_as_array<T, Size>(input, delim);
+  if (!result) {
+    throw result.error().to_exception();
+  }
+  return *result;
+}
+
 }
 
 #endif // ICONFIGP_ARRAY_HPP_INCLUDED
@@ -0,0 +1,103 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_COLUMNS_HPP_INCLUDED
+#define ICONFIGP_COLUMNS_HPP_INCLUDED
+
+#include "iconfigp/parallel.hpp"
+#include "iconfigp/section.hpp"
+#include "iconfigp/value-parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+struct row_error {
+  size_t             row;
+  std::exception_ptr error;
+};
+
+
+
+// One row per non-empty group of a section, one typed column per key. A cell is empty if
+// the key is missing in that group or the row failed; failed rows are listed in errors.
+template<value_parser_defined... Ts>
+struct column_table {
+  std::tuple<std::vector<std::optional<Ts>>...> columns;
+  std::vector<size_t>                           groups; // index of the group of each row
+  std::vector<row_error>                        errors; // ordered by row
+
+  [[nodiscard]] size_t rows() const { return groups.size(); }
+
+  template<size_t Index>
+  [[nodiscard]] const auto& column() const { return std::get<Index>(columns); }
+};
+
+
+
+// Parses the given keys of all groups into columns in a single pass. If parallel is set,
+// rows are converted in chunks on separate threads. The errors refer to keys of sec.
+template<value_parser_defined... Ts>
+[[nodiscard]] column_table<Ts...> extract_columns(
+    const section&                                     sec,
+    const std::array<std::string_view, sizeof...(Ts)>& keys,
+    bool                                               parallel = false
+) {
+  column_table<Ts...> table;
+
+  auto groups = sec.groups();
+  for (size_t i = 0; i < groups.size(); ++i) {
+    if (!groups[i].empty()) {
+      table.groups.push_back(i);
+    }
+  }
+
+  std::apply([&table](auto&... column) { (column.resize(table.rows()), ...); },
+      table.columns);
+
+
+
+  static constexpr size_t min_parallel_chunk = 1024;
+
+  std::vector<std::exception_ptr> failures(table.rows());
+
+  detail::for_each_chunk(table.rows(), min_parallel_chunk, parallel,
+      [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+          try {
+            auto values = std::apply([&](auto... key) {
+              return groups[table.groups[row]].unique_keys(key...);
+            }, keys);
+
+            [&]<size_t... Index>(std::index_sequence<Index...>) {
+              ((std::get<Index>(table.columns)[row] = parse<Ts>(values[Index])), ...);
+            }(std::index_sequence_for<Ts...>{});
+
+          } catch (...) {
+            std::apply([row](auto&... column) { (column[row].reset(), ...); }, table.columns);
+            failures[row] = std::current_exception();
+          }
+        }
+      });
+
+  for (size_t row = 0; row < failures.size(); ++row) {
+    if (failures[row]) {
+      table.errors.push_back(row_error{row, std::move(failures[row])});
+    }
+  }
+
+  return table;
+}
+
+}
+
+#endif // ICONFIGP_COLUMNS_HPP_INCLUDED
@@ -8,17 +8,57 @@
 #include "iconfigp/key-value.hpp"
 #include "iconfigp/opt-ref.hpp"
 
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 
 
 namespace iconfigp {
 
 class exception : public std::runtime_error {
+  public:
+    // messages of exceptions implementing describe() are only formatted on first access
+    [[nodiscard]] const char* what() const noexcept override {
+      if (!message_) {
+        return std::runtime_error::what();
+      }
+
+      try {
+        std::call_once(message_->once, [this] { message_->text = describe(); });
+        return message_->text.c_str();
+      } catch (...) {
+        return "iconfigp::exception";
+      }
+    }
+
+
+
   protected:
     explicit exception(const std::string& message) :
       std::runtime_error{message}
     {}
+
+    exception() :
+      std::runtime_error{""},
+      message_          {std::make_shared<lazy_message>()}
+    {}
+
+    [[nodiscard]] virtual std::string describe() const { return {}; }
+
+
+
+  private:
+    struct lazy_message {
+      std::once_flag once;
+      std::string    text;
+    };
+
+    // shared by all copies of the exception
+    std::shared_ptr<lazy_message> message_;
 };
 
 
@@ -28,7 +68,6 @@ class exception : public std::runtime_error {
 class missing_key_exception: public exception {
   public:
     missing_key_exception(std::string key, size_t offset) :
-      exception{iconfigp::format("missing key {} in group", key)},
       key_     {std::move(key)},
       offset_  {offset}
     {}
@@ -43,6 +82,10 @@ class missing_key_exception: public exception {
   private:
     std::string key_;
     size_t      offset_;
+
+    [[nodiscard]] std::string describe() const override {
+      return iconfigp::format("missing key {} in group", key_);
+    }
 };
 
 
@@ -54,8 +97,6 @@ class value_parse_exception: public exception {
     class range_exception : public exception {
       public:
         range_exception(std::string message, size_t offset, size_t size = 0) :
-          exception{iconfigp::format("cannot parse value range ({}:{}): {}",
-                    offset, size, message)},
           offset_  {offset},
           size_    {size},
           message_ {std::move(message)}
@@ -73,6 +114,11 @@ class value_parse_exception: public exception {
         size_t size_;
 
         std::string message_;
+
+        [[nodiscard]] std::string describe() const override {
+          return iconfigp::format("cannot parse value range ({}:{}): {}",
+                    offset_, size_, message_);
+        }
     };
 
 
@@ -83,17 +129,31 @@ class value_parse_exception: public exception {
         std::string                    format,
         std::optional<range_exception> range_ex = {}
     ) :
-      exception{iconfigp::format("cannot parse value of {} as {}", value.key(), target)},
-      value_   {std::move(value)},
-      target_  {std::move(target)},
-      format_  {std::move(format)},
+      owned_   {std::make_shared<const storage>(
+                  std::move(value), std::move(target), std::move(format))},
+      value_   {&*owned_->value},
+      target_  {owned_->target},
+      format_  {owned_->format},
 
       range_exception_{std::move(range_ex)}
     {}
 
 
 
-    [[nodiscard]] const key_value& value()  const { return value_;  }
+    // refers to value, target and format, which have to outlive the exception unless
+    // detach() is called; this is what parse<T> throws
+    [[nodiscard]] static value_parse_exception borrowing(
+        const key_value&               value,
+        std::string_view               target,
+        std::string_view               format,
+        std::optional<range_exception> range_ex = {}
+    ) {
+      return value_parse_exception{borrow{}, value, target, format, std::move(range_ex)};
+    }
+
+
+
+    [[nodiscard]] const key_value& value()  const { return *value_; }
 
     [[nodiscard]] std::string_view target() const { return target_; }
     [[nodiscard]] std::string_view format() const { return format_; }
@@ -108,12 +168,58 @@ class value_parse_exception: public exception {
 
 
 
+    // copies value, target and format into the exception
+    void detach() {
+      if (!owned_) {
+        *this = value_parse_exception{*value_, std::string{target_}, std::string{format_},
+                                      std::move(range_exception_)};
+      }
+    }
+
+
+
   private:
-    key_value   value_;
-    std::string target_;
-    std::string format_;
+    struct borrow {};
+
+    value_parse_exception(
+        borrow                         /*tag*/,
+        const key_value&               value,
+        std::string_view               target,
+        std::string_view               format,
+        std::optional<range_exception> range_ex
+    ) :
+      value_   {&value},
+      target_  {target},
+      format_  {format},
+
+      range_exception_{std::move(range_ex)}
+    {}
+
+
+
+    struct storage {
+      std::optional<key_value> value;
+      std::string              target;
+      std::string              format;
+
+      storage(key_value v, std::string t, std::string f) :
+        value {std::move(v)},
+        target{std::move(t)},
+        format{std::move(f)}
+      {}
+    };
+
+    std::shared_ptr<const storage> owned_;
+
+    const key_value*               value_;
+    std::string_view               target_;
+    std::string_view               format_;
 
     std::optional<range_exception> range_exception_;
+
+    [[nodiscard]] std::string describe() const override {
+      return iconfigp::format("cannot parse value of {} as {}", value_->key(), target_);
+    }
 };
 
 
@@ -127,8 +233,6 @@ class multiple_definitions_exception: public exception {
         key_value definition2,
         bool      per_section
     ) :
-      exception   {iconfigp::format("multiple definitions of the same key {}",
-                     definition1.key())},
       definition1_{std::move(definition1)},
       definition2_{std::move(definition2)},
       per_section_{per_section}
@@ -146,6 +250,55 @@ class multiple_definitions_exception: public exception {
     key_value definition1_;
     key_value definition2_;
     bool      per_section_;
+
+    [[nodiscard]] std::string describe() const override {
+      return iconfigp::format("multiple definitions of the same key {}", definition1_.key());
+    }
+};
+
+
+
+
+
+class unknown_key_exception: public exception {
+  public:
+    explicit unknown_key_exception(key_value definition) :
+      exception  {iconfigp::format("unknown key {}", definition.key())},
+      definition_{std::move(definition)}
+    {}
+
+
+
+    [[nodiscard]] const key_value& definition() const { return definition_; }
+
+
+
+  private:
+    key_value definition_;
+};
+
+
+
+
+
+class unknown_section_exception: public exception {
+  public:
+    unknown_section_exception(std::string name, size_t offset) :
+      exception{iconfigp::format("unknown section {}", name)},
+      name_    {std::move(name)},
+      offset_  {offset}
+    {}
+
+
+
+    [[nodiscard]] std::string_view name()   const { return name_;   }
+    [[nodiscard]] size_t           offset() const { return offset_; }
+
+
+
+  private:
+    std::string name_;
+    size_t      offset_;
 };
 
 
@@ -164,6 +317,7 @@ enum class syntax_error_type {
   missing_section_end,
   missing_value,
   empty_key,
+  empty_include,
 };
 
 
@@ -172,6 +326,7 @@ enum class task_type {
   key,
   value,
   section,
+  include,
   toplevel,
 };
 
@@ -205,6 +360,49 @@ class syntax_exception : public exception {
     task_type         task_;
 };
 
+
+
+
+
+enum class include_error_type {
+  unreadable,
+  cycle,
+};
+
+
+
+class include_exception : public exception {
+  public:
+    include_exception(
+        include_error_type type,
+        std::string        path,
+        size_t             offset,
+        size_t             size
+    ) :
+      exception{iconfigp::format("cannot include {}", path)},
+      type_    {type},
+      path_    {std::move(path)},
+      offset_  {offset},
+      size_    {size}
+    {}
+
+
+
+    [[nodiscard]] include_error_type type()   const { return type_;   }
+    [[nodiscard]] std::string_view   path()   const { return path_;   }
+
+    [[nodiscard]] size_t             offset() const { return offset_; }
+    [[nodiscard]] size_t             size()   const { return size_;   }
+
+
+
+  private:
+    include_error_type type_;
+    std::string        path_;
+    size_t             offset_;
+    size_t             size_;
+};
+
 }
 
 
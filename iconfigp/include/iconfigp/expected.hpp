@@ -0,0 +1,104 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_EXPECTED_HPP_INCLUDED
+#define ICONFIGP_EXPECTED_HPP_INCLUDED
+
+#include <version>
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#define STD_EXPECTED
+#endif
+
+
+
+#if defined(STD_EXPECTED)
+#include <expected>
+#else
+#include <type_traits>
+#include <utility>
+#include <variant>
+#endif
+
+
+
+namespace iconfigp {
+
+#if defined(STD_EXPECTED)
+
+using std::expected;
+using std::unexpected;
+
+#else
+
+template<typename E>
+class unexpected {
+  public:
+    explicit unexpected(E error) :
+      error_{std::move(error)}
+    {}
+
+
+
+    [[nodiscard]] E&        error() &        { return error_;            }
+    [[nodiscard]] const E&  error() const &  { return error_;            }
+    [[nodiscard]] E&&       error() &&       { return std::move(error_); }
+
+
+
+  private:
+    E error_;
+};
+
+template<typename E>
+unexpected(E) -> unexpected<E>;
+
+
+
+// the part of std::expected used by iconfigp
+template<typename T, typename E>
+class expected {
+  public:
+    template<typename U = T>
+      requires std::is_constructible_v<T, U&&>
+    expected(U&& value) : // NOLINT(*-explicit-*)
+      storage_{std::in_place_index<0>, std::forward<U>(value)}
+    {}
+
+    template<typename G>
+    expected(unexpected<G> error) : // NOLINT(*-explicit-*)
+      storage_{std::in_place_index<1>, std::move(error).error()}
+    {}
+
+
+
+    [[nodiscard]] bool has_value()     const { return storage_.index() == 0; }
+    [[nodiscard]] explicit operator bool() const { return has_value(); }
+
+    [[nodiscard]] T&       operator*()  &      { return std::get<0>(storage_); }
+    [[nodiscard]] const T& operator*()  const& { return std::get<0>(storage_); }
+    [[nodiscard]] T&&      operator*()  &&     { return std::get<0>(std::move(storage_)); }
+
+    [[nodiscard]] T*       operator->()        { return &std::get<0>(storage_); }
+    [[nodiscard]] const T* operator->() const  { return &std::get<0>(storage_); }
+
+    [[nodiscard]] E&       error()      &      { return std::get<1>(storage_); }
+    [[nodiscard]] const E& error()      const& { return std::get<1>(storage_); }
+    [[nodiscard]] E&&      error()      &&     { return std::get<1>(std::move(storage_)); }
+
+    template<typename U>
+    [[nodiscard]] T value_or(U&& fallback) const& {
+      return has_value() ? **this : static_cast<T>(std::forward<U>(fallback));
+    }
+
+
+
+  private:
+    std::variant<T, E> storage_;
+};
+
+#endif
+
+}
+
+#endif // ICONFIGP_EXPECTED_HPP_INCLUDED
@@ -6,6 +6,8 @@
 
 #include <filesystem>
 #include <optional>
+#include <string>
+#include <vector>
 
 
 
@@ -13,6 +15,23 @@ namespace iconfigp {
 
 [[nodiscard]] std::optional<std::filesystem::path> find_config_file(std::string_view);
 
+// all existing system config files ($XDG_CONFIG_DIRS) followed by the user config file
+// (see find_config_file), ordered from lowest to highest precedence
+[[nodiscard]] std::vector<std::filesystem::path> find_config_files(std::string_view);
+
+
+
+struct environment_override {
+  std::string              variable;
+  std::vector<std::string> section;
+  std::string              key;
+  std::string              value;
+};
+
+// all environment variables of the form NAME__SECTION__SUBSECTION__KEY; the environment is
+// scanned once, names are converted to lower case and _ is replaced by -
+[[nodiscard]] std::vector<environment_override> find_environment_overrides(std::string_view);
+
 }
 
 #endif // ICONFIGP_FIND_CONFIG_HPP_INCLUDED
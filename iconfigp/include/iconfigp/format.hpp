@@ -4,6 +4,10 @@
 #ifndef ICONFIGP_FORMAT_HPP_INCLUDED
 #define ICONFIGP_FORMAT_HPP_INCLUDED
 
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <version>
 
 #if !defined(__cpp_lib_format) && !defined(_LIBCPP_VERSION) && __GNUC__ < 13
@@ -93,6 +97,17 @@ struct text_line {
 
 
 
+// one of possibly several files making up a document, content[0] is located at offset
+struct source_file {
+  std::string      name;
+  std::string_view content;
+  size_t           offset;
+};
+
+
+
+
+
 class exception;
 
 [[nodiscard]] std::string format_exception(
@@ -102,6 +117,34 @@ class exception;
     size_t           /*line_width*/ = max_line_width
 );
 
+[[nodiscard]] std::string format_exception(
+    const exception&,
+    std::span<const source_file> /*sources*/,
+    bool                         /*colored*/    = false,
+    size_t                       /*line_width*/ = max_line_width
+);
+
+
+
+
+
+struct validation_report;
+
+// all errors of the report, the sources are only indexed once for all of them
+[[nodiscard]] std::string format_report(
+    const validation_report&,
+    std::string_view /*source*/     = "",
+    bool             /*colored*/    = false,
+    size_t           /*line_width*/ = max_line_width
+);
+
+[[nodiscard]] std::string format_report(
+    const validation_report&,
+    std::span<const source_file> /*sources*/,
+    bool                         /*colored*/    = false,
+    size_t                       /*line_width*/ = max_line_width
+);
+
 
 
 
@@ -115,6 +158,13 @@ class section;
     size_t           /*max_width*/ = max_line_width
 );
 
+[[nodiscard]] std::optional<std::string> format_unused_message(
+    const section&,
+    std::span<const source_file> /*sources*/,
+    bool                         /*colored*/   = false,
+    size_t                       /*max_width*/ = max_line_width
+);
+
 
 }
 
@@ -0,0 +1,556 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_FROZEN_DOCUMENT_HPP_INCLUDED
+#define ICONFIGP_FROZEN_DOCUMENT_HPP_INCLUDED
+
+#include "iconfigp/exception.hpp"
+#include "iconfigp/key-value.hpp"
+#include "iconfigp/key.hpp"
+#include "iconfigp/section.hpp"
+#include "iconfigp/value-parser.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+namespace detail {
+  [[nodiscard]] uint32_t next_generation();
+}
+
+
+
+// One bit per node, set concurrently by const accessors.
+class flag_set {
+  public:
+    explicit flag_set(size_t count = 0) :
+      words_((count + word_bits - 1) / word_bits)
+    {}
+
+
+
+    [[nodiscard]] bool test(size_t index) const {
+      return (words_[index / word_bits].load(std::memory_order_relaxed) & mask(index)) != 0;
+    }
+
+    void set(size_t index) const {
+      if (!test(index)) {
+        words_[index / word_bits].fetch_or(mask(index), std::memory_order_relaxed);
+      }
+    }
+
+
+
+    [[nodiscard]] size_t memory_usage() const {
+      return words_.capacity() * sizeof(std::atomic<uint64_t>);
+    }
+
+
+
+  private:
+    static constexpr size_t word_bits = 64;
+
+    mutable std::vector<std::atomic<uint64_t>> words_;
+
+    [[nodiscard]] static uint64_t mask(size_t index) {
+      return uint64_t{1} << (index % word_bits);
+    }
+};
+
+
+
+
+
+// Read-only copy of a section tree stored in a few contiguous arrays: sections in
+// preorder, their groups and the keys of these groups one after another, and all
+// strings in a single arena. Views refer to nodes by index and offer the same read API
+// as section, group and key_value. Key lookups in a section use a hash index, which
+// hashed_key literals ("name"_key) probe without hashing at runtime.
+//
+// All offsets, sizes and indices are stored as Offset, i.e., compact_frozen_document
+// halves the size of the tables for documents below 4 GiB; construction throws
+// std::length_error if a value does not fit.
+template<std::unsigned_integral Offset>
+class basic_frozen_document {
+  private:
+    struct string_ref {
+      Offset begin;
+      Offset size;
+    };
+
+    struct section_table {
+      std::vector<string_ref> name;
+      std::vector<Offset>     offset;
+      std::vector<Offset>     parent;
+      std::vector<Offset>     end;    // one past the last descendant
+      std::vector<Offset>     groups; // first group, followed by a sentinel
+      std::vector<Offset>     slots;  // first slot of the key index, followed by a sentinel
+      flag_set                used;
+    };
+
+    struct group_table {
+      std::vector<Offset>     offset;
+      std::vector<Offset>     keys;   // first key, followed by a sentinel
+    };
+
+    struct key_table {
+      std::vector<string_ref> key;
+      std::vector<string_ref> value;
+      std::vector<Offset>     key_offset;
+      std::vector<Offset>     key_size;
+      std::vector<Offset>     value_offset;
+      std::vector<Offset>     value_size;
+      std::vector<Offset>     hash;   // key_hash truncated to Offset
+      flag_set                used;
+    };
+
+
+
+
+  public:
+    class key_view;
+    class group_view;
+    class section_view;
+
+
+
+    template<typename View>
+    class view_range {
+      public:
+        class iterator {
+          public:
+            using value_type        = View;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() = default;
+
+            iterator(const basic_frozen_document* doc, size_t index) :
+              doc_  {doc},
+              index_{index}
+            {}
+
+            [[nodiscard]] View operator*() const { return View{*doc_, index_}; }
+
+            iterator& operator++() {
+              index_ = View{*doc_, index_}.next_index();
+              return *this;
+            }
+
+            iterator operator++(int) {
+              auto copy = *this;
+              ++*this;
+              return copy;
+            }
+
+            [[nodiscard]] bool operator==(const iterator& rhs) const {
+              return index_ == rhs.index_;
+            }
+
+          private:
+            const basic_frozen_document* doc_  {nullptr};
+            size_t                       index_{0};
+        };
+
+
+
+        view_range(const basic_frozen_document& doc, size_t begin, size_t end) :
+          doc_  {&doc},
+          begin_{begin},
+          end_  {end}
+        {}
+
+        [[nodiscard]] iterator begin() const { return iterator{doc_, begin_}; }
+        [[nodiscard]] iterator end()   const { return iterator{doc_, end_};   }
+
+        [[nodiscard]] bool     empty() const { return begin_ == end_;         }
+
+
+
+      private:
+        const basic_frozen_document* doc_;
+        size_t                       begin_;
+        size_t                       end_;
+    };
+
+
+
+
+
+    class key_view {
+      public:
+        key_view(const basic_frozen_document& doc, size_t index) :
+          doc_  {&doc},
+          index_{index}
+        {}
+
+
+
+        [[nodiscard]] size_t key_offset()   const { return keys().key_offset[index_];   }
+        [[nodiscard]] size_t key_size()     const { return keys().key_size[index_];     }
+        [[nodiscard]] size_t value_offset() const { return keys().value_offset[index_]; }
+        [[nodiscard]] size_t value_size()   const { return keys().value_size[index_];   }
+
+        [[nodiscard]] bool   used()         const { return keys().used.test(index_);    }
+
+        [[nodiscard]] std::string_view key() const {
+          return doc_->string(keys().key[index_]);
+        }
+
+        [[nodiscard]] std::string_view value() const {
+          keys().used.set(index_);
+          return doc_->string(keys().value[index_]);
+        }
+
+        // copy of the key for exceptions and APIs which expect a key_value
+        [[nodiscard]] key_value to_key_value() const {
+          return key_value{
+            located_string{std::string{key()},   key_offset(),   key_size()},
+            located_string{std::string{doc_->string(keys().value[index_])},
+                           value_offset(), value_size()}
+          };
+        }
+
+        [[nodiscard]] size_t index()      const { return index_;     }
+        [[nodiscard]] size_t next_index() const { return index_ + 1; }
+
+
+
+      private:
+        const basic_frozen_document* doc_;
+        size_t                       index_;
+
+        [[nodiscard]] const key_table& keys() const { return doc_->keys_; }
+    };
+
+
+
+
+
+    class group_view {
+      public:
+        group_view(const basic_frozen_document& doc, size_t index) :
+          doc_  {&doc},
+          index_{index}
+        {}
+
+
+
+        [[nodiscard]] size_t offset() const { return doc_->groups_.offset[index_]; }
+
+        [[nodiscard]] bool   empty()  const { return keys_begin() == keys_end(); }
+
+        [[nodiscard]] view_range<key_view> entries() const {
+          return {*doc_, keys_begin(), keys_end()};
+        }
+
+
+
+        [[nodiscard]] std::optional<key_view> unique_key(std::string_view name) const {
+          return unique_key(hashed_key{name});
+        }
+
+        [[nodiscard]] std::optional<key_view> unique_key(const hashed_key& name) const {
+          auto hash = static_cast<Offset>(name.hash());
+
+          std::optional<key_view> output;
+
+          for (size_t i = keys_begin(); i < keys_end(); ++i) {
+            key_view kv{*doc_, i};
+            if (doc_->keys_.hash[i] == hash && kv.key() == name.name()) {
+              if (output) {
+                throw multiple_definitions_exception{output->to_key_value(),
+                  kv.to_key_value(), false};
+              }
+              output = kv;
+            }
+          }
+
+          return output;
+        }
+
+
+
+        [[nodiscard]] key_view require_unique_key(std::string_view name) const {
+          return require_unique_key(hashed_key{name});
+        }
+
+        [[nodiscard]] key_view require_unique_key(const hashed_key& name) const {
+          if (auto kv = unique_key(name)) {
+            return *kv;
+          }
+          throw missing_key_exception{std::string{name.name()}, offset()};
+        }
+
+
+
+        [[nodiscard]] size_t count_keys(std::string_view name) const {
+          return std::ranges::count_if(entries(),
+              [name](auto kv) { return kv.key() == name; });
+        }
+
+
+
+        [[nodiscard]] size_t index()      const { return index_;     }
+        [[nodiscard]] size_t next_index() const { return index_ + 1; }
+
+
+
+      private:
+        const basic_frozen_document* doc_;
+        size_t                       index_;
+
+        [[nodiscard]] size_t keys_begin() const { return doc_->groups_.keys[index_];     }
+        [[nodiscard]] size_t keys_end()   const { return doc_->groups_.keys[index_ + 1]; }
+    };
+
+
+
+
+
+    class section_view {
+      public:
+        section_view(const basic_frozen_document& doc, size_t index) :
+          doc_  {&doc},
+          index_{index}
+        {}
+
+
+
+        [[nodiscard]] size_t offset() const { return sections().offset[index_]; }
+
+        [[nodiscard]] std::string_view name() const {
+          mark_used();
+          return doc_->string(sections().name[index_]);
+        }
+
+
+
+        [[nodiscard]] view_range<group_view> groups() const {
+          mark_used();
+          return {*doc_, sections().groups[index_], sections().groups[index_ + 1]};
+        }
+
+        [[nodiscard]] view_range<section_view> subsections() const {
+          mark_used();
+          return {*doc_, index_ + 1, next_index()};
+        }
+
+        [[nodiscard]] std::optional<section_view> parent() const {
+          if (index_ == 0) {
+            return {};
+          }
+          return section_view{*doc_, sections().parent[index_]};
+        }
+
+
+
+        [[nodiscard]] std::optional<section_view> subsection(std::string_view name) const {
+          mark_used();
+
+          for (size_t i = index_ + 1; i < next_index(); i = sections().end[i]) {
+            if (doc_->string(sections().name[i]) == name) {
+              sections().used.set(i);
+              return section_view{*doc_, i};
+            }
+          }
+          return {};
+        }
+
+
+
+        [[nodiscard]] std::optional<key_view> unique_key(std::string_view name) const {
+          return unique_key(hashed_key{name});
+        }
+
+        // probes the hash index of the section, duplicates are reported by scanning
+        [[nodiscard]] std::optional<key_view> unique_key(const hashed_key& name) const {
+          mark_used();
+
+          size_t first = sections().slots[index_];
+          size_t mask  = sections().slots[index_ + 1] - first - 1;
+
+          if (sections().slots[index_ + 1] == first) {
+            return {};
+          }
+
+          auto hash = static_cast<Offset>(name.hash());
+
+          std::optional<key_view> output;
+
+          for (size_t probe = hash & mask;; probe = (probe + 1) & mask) {
+            size_t slot = doc_->slots_[first + probe];
+            if (slot == 0) {
+              break;
+            }
+
+            key_view kv{*doc_, slot - 1};
+            if (doc_->keys_.hash[slot - 1] != hash || kv.key() != name.name()) {
+              continue;
+            }
+
+            if (output) {
+              return scan_unique_key(name.name());
+            }
+            output = kv;
+          }
+
+          return output;
+        }
+
+
+
+        [[nodiscard]] key_view require_unique_key(std::string_view name) const {
+          return require_unique_key(hashed_key{name});
+        }
+
+        [[nodiscard]] key_view require_unique_key(const hashed_key& name) const {
+          if (auto kv = unique_key(name)) {
+            return *kv;
+          }
+          throw missing_key_exception{std::string{name.name()}, offset()};
+        }
+
+
+
+        [[nodiscard]] size_t count_keys(std::string_view name) const {
+          mark_used();
+
+          size_t count{0};
+          for (auto grp: groups()) {
+            count += grp.count_keys(name);
+          }
+          return count;
+        }
+
+
+
+        [[nodiscard]] bool   used()       const { return sections().used.test(index_); }
+
+        [[nodiscard]] size_t index()      const { return index_;                       }
+        [[nodiscard]] size_t next_index() const { return sections().end[index_];       }
+
+
+
+      private:
+        const basic_frozen_document* doc_;
+        size_t                       index_;
+
+        [[nodiscard]] const section_table& sections() const { return doc_->sections_; }
+
+        void mark_used() const { sections().used.set(index_); }
+
+
+
+        [[nodiscard]] std::optional<key_view> scan_unique_key(std::string_view name) const {
+          std::optional<key_view> output;
+
+          for (auto grp: groups()) {
+            if (auto kv = grp.unique_key(name)) {
+              if (output) {
+                throw multiple_definitions_exception{output->to_key_value(),
+                  kv->to_key_value(), true};
+              }
+              output = kv;
+            }
+          }
+
+          return output;
+        }
+    };
+
+
+
+
+
+    explicit basic_frozen_document(const section&);
+
+    [[nodiscard]] section_view root() const { return section_view{*this, 0}; }
+
+    // unique among all frozen documents of the process, never 0
+    [[nodiscard]] uint32_t generation() const { return generation_; }
+
+    [[nodiscard]] size_t section_count() const { return sections_.offset.size(); }
+    [[nodiscard]] size_t group_count()   const { return groups_.offset.size();   }
+    [[nodiscard]] size_t key_count()     const { return keys_.key.size();        }
+
+    // keys never read in used sections, and unused sections, like section::unused_keys
+    // and section::unused_sections
+    [[nodiscard]] std::vector<key_view>     unused_keys()     const;
+    [[nodiscard]] std::vector<section_view> unused_sections() const;
+
+    // heap memory in bytes used by the arrays and the string arena
+    [[nodiscard]] size_t memory_usage() const;
+
+
+
+  private:
+    uint32_t            generation_;
+
+    std::string         arena_;
+    section_table       sections_;
+    group_table         groups_;
+    key_table           keys_;
+
+    // per section an open addressing table of key index + 1 (0 marks an empty slot)
+    std::vector<Offset> slots_;
+
+
+
+    [[nodiscard]] std::string_view string(string_ref ref) const {
+      return std::string_view{arena_}.substr(ref.begin, ref.size);
+    }
+
+    [[nodiscard]] string_ref store(std::string_view);
+
+    void add(const section&, size_t /*parent*/);
+    void build_index();
+
+    [[nodiscard]] static Offset narrow(size_t);
+};
+
+
+
+using frozen_document         = basic_frozen_document<uint64_t>;
+using compact_frozen_document = basic_frozen_document<uint32_t>;
+
+extern template class basic_frozen_document<uint64_t>;
+extern template class basic_frozen_document<uint32_t>;
+
+
+
+template<typename View>
+concept frozen_key_view = requires (const View& kv) {
+  { kv.to_key_value() } -> std::same_as<key_value>;
+};
+
+template<value_parser_defined T, frozen_key_view View>
+[[nodiscard]] T parse(const View& kv) {
+  try {
+    if (auto result = value_parser<T>::parse(kv.value())) {
+      return *result;
+    }
+  } catch (...) {}
+
+  // failure path: reuse the diagnostics of parse(const key_value&)
+  auto copy = kv.to_key_value();
+  try {
+    return parse<T>(copy);
+  } catch (value_parse_exception& ex) {
+    ex.detach();
+    throw;
+  }
+}
+
+}
+
+#endif // ICONFIGP_FROZEN_DOCUMENT_HPP_INCLUDED
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_GENERATOR_HPP_INCLUDED
+#define ICONFIGP_GENERATOR_HPP_INCLUDED
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+
+
+namespace iconfigp {
+
+// Minimal single-pass coroutine generator (a subset of C++23 std::generator). Exceptions
+// thrown by the coroutine are rethrown when advancing the iterator.
+template<typename T>
+class generator {
+  public:
+    struct promise_type {
+      std::optional<T>   value;
+      std::exception_ptr error;
+
+      generator get_return_object() {
+        return generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_always final_suspend()   noexcept { return {}; }
+
+      std::suspend_always yield_value(T output) {
+        value = std::move(output);
+        return {};
+      }
+
+      void return_void() {}
+
+      void unhandled_exception() { error = std::current_exception(); }
+    };
+
+
+
+    class iterator {
+      public:
+        using value_type      = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> handle) :
+          handle_{handle}
+        {}
+
+        [[nodiscard]] T& operator*() const { return *handle_.promise().value; }
+
+        iterator& operator++() {
+          advance(handle_);
+          return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        [[nodiscard]] bool operator==(std::default_sentinel_t /*end*/) const {
+          return !handle_ || handle_.done();
+        }
+
+      private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+
+
+    generator(const generator&) = delete;
+    generator& operator=(const generator&) = delete;
+
+    generator(generator&& other) noexcept :
+      handle_{std::exchange(other.handle_, {})}
+    {}
+
+    generator& operator=(generator&& other) noexcept {
+      if (this != &other) {
+        if (handle_) {
+          handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, {});
+      }
+      return *this;
+    }
+
+    ~generator() {
+      if (handle_) {
+        handle_.destroy();
+      }
+    }
+
+
+
+    // may only be called once
+    [[nodiscard]] iterator begin() {
+      advance(handle_);
+      return iterator{handle_};
+    }
+
+    [[nodiscard]] std::default_sentinel_t end() const { return {}; }
+
+
+
+  private:
+    std::coroutine_handle<promise_type> handle_;
+
+    explicit generator(std::coroutine_handle<promise_type> handle) :
+      handle_{handle}
+    {}
+
+    static void advance(std::coroutine_handle<promise_type> handle) {
+      handle.promise().value.reset();
+      handle.resume();
+      if (auto error = std::exchange(handle.promise().error, {})) {
+        std::rethrow_exception(error);
+      }
+    }
+};
+
+}
+
+#endif // ICONFIGP_GENERATOR_HPP_INCLUDED
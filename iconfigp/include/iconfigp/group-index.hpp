@@ -0,0 +1,162 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_GROUP_INDEX_HPP_INCLUDED
+#define ICONFIGP_GROUP_INDEX_HPP_INCLUDED
+
+#include "iconfigp/key.hpp"
+#include "iconfigp/stats.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+// Lazily built map from (key, value) to the indices of the groups containing that pair,
+// one value map per key. The index refers to the strings of the tree it was built for,
+// copies and moves therefore start out empty. Until the first lookup, the index only
+// takes up a single pointer.
+class group_index {
+  public:
+    using value_map = std::unordered_map<std::string_view, std::vector<size_t>>;
+
+
+
+    group_index() = default;
+
+    group_index(const group_index& /*other*/) {}
+    group_index(group_index&& /*other*/) noexcept {}
+
+    group_index& operator=(const group_index& /*other*/) {
+      clear();
+      return *this;
+    }
+
+    group_index& operator=(group_index&& /*other*/) noexcept {
+      clear();
+      return *this;
+    }
+
+    ~group_index() {
+      clear();
+    }
+
+
+
+    // build is called once per key and has to return its value_map
+    template<typename Build>
+    [[nodiscard]] std::span<const size_t> find(
+        std::string_view key,
+        std::string_view value,
+        Build&&          build
+    ) const {
+      auto& idx = storage();
+
+      {
+        std::shared_lock lock{idx.mutex};
+        if (auto it = idx.keys.find(key); it != idx.keys.end()) {
+          return lookup(it->second, value);
+        }
+      }
+
+      auto map = std::forward<Build>(build)(key);
+
+      std::unique_lock lock{idx.mutex};
+      auto [it, inserted] = idx.keys.try_emplace(std::string{key}, std::move(map));
+      return lookup(it->second, value);
+    }
+
+
+
+    // approximate heap memory (in bytes) of the index, 0 until the first lookup
+    [[nodiscard]] size_t memory_usage() const {
+      auto* idx = storage_.load(std::memory_order_acquire);
+      if (idx == nullptr) {
+        return 0;
+      }
+
+      std::shared_lock lock{idx->mutex};
+
+      size_t total = sizeof(index) + idx->keys.bucket_count() * sizeof(void*);
+
+      for (const auto& [key, map]: idx->keys) {
+        // node overhead, plus the heap buffer if the key is not stored inline
+        total += sizeof(void*) + sizeof(key_map::value_type) + sizeof(size_t)
+          + detail::heap_size(key) + map.bucket_count() * sizeof(void*);
+
+        for (const auto& [value, indices]: map) {
+          total += sizeof(void*) + sizeof(value_map::value_type) + sizeof(size_t)
+            + detail::heap_size(indices);
+        }
+      }
+
+      return total;
+    }
+
+
+
+    // not synchronized, only called while the tree is modified; the parser calls this for
+    // every key, so it only costs a plain load as long as there is no index
+    void clear() {
+      if (storage_.load(std::memory_order_relaxed) != nullptr) {
+        delete storage_.exchange(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+
+
+  private:
+    using key_map = std::unordered_map<std::string, value_map, detail::string_hash,
+                                       std::equal_to<>>;
+
+    struct index {
+      std::shared_mutex mutex;
+      key_map           keys;
+    };
+
+    mutable std::atomic<index*> storage_{nullptr};
+
+
+
+    // allocated by the first lookup, concurrent first lookups keep only one allocation
+    [[nodiscard]] index& storage() const {
+      if (auto* idx = storage_.load(std::memory_order_acquire)) {
+        return *idx;
+      }
+
+      auto   fresh    = std::make_unique<index>();
+      index* expected = nullptr;
+
+      if (storage_.compare_exchange_strong(expected, fresh.get(),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *fresh.release();
+      }
+      return *expected;
+    }
+
+
+
+    [[nodiscard]] static std::span<const size_t> lookup(
+        const value_map& map,
+        std::string_view value
+    ) {
+      if (auto it = map.find(value); it != map.end()) {
+        return it->second;
+      }
+      return {};
+    }
+};
+
+}
+
+#endif // ICONFIGP_GROUP_INDEX_HPP_INCLUDED
@@ -9,7 +9,10 @@
 #include "iconfigp/opt-ref.hpp"
 
 #include <algorithm>
+#include <array>
+#include <concepts>
 #include <span>
+#include <string_view>
 #include <vector>
 
 
@@ -18,7 +21,9 @@ namespace iconfigp {
 
 
 class group {
+  friend class schema;
   friend class section;
+  friend size_t memory_usage(const section&);
 
   public:
     [[nodiscard]] size_t                     offset()  const { return offset_;         }
@@ -29,18 +34,8 @@ class group {
 
 
     [[nodiscard]] opt_ref<const key_value> unique_key(std::string_view name) const {
-      opt_ref<const key_value> output;
-
-      for (const auto& kv: values_) {
-        if (kv.key() == name) {
-          if (output) {
-            throw multiple_definitions_exception{*output, kv, false};
-          }
-          output = kv;
-        }
-      }
-
-      return output;
+      [[maybe_unused]] access_timer timer;
+      return find_unique_key(name);
     }
 
 
@@ -54,6 +49,23 @@ class group {
 
 
 
+    // unique_key for every name in a single pass over the entries
+    template<std::convertible_to<std::string_view>... Names>
+    [[nodiscard]] std::array<opt_ref<const key_value>, sizeof...(Names)> unique_keys(
+        const Names&... names
+    ) const {
+      [[maybe_unused]] access_timer timer;
+
+      std::array<std::string_view, sizeof...(Names)>         keys{names...};
+      std::array<opt_ref<const key_value>, sizeof...(Names)> output;
+
+      find_unique_keys(keys, output);
+
+      return output;
+    }
+
+
+
     [[nodiscard]] size_t count_keys(std::string_view name) const {
       return std::ranges::count_if(values_,
           [name](const auto& kv) { return kv.key() == name; });
@@ -77,6 +89,51 @@ class group {
     void append(Args&&... args) {
       values_.push_back(key_value{std::forward<Args>(args)...});
     }
+
+
+
+    [[nodiscard]] opt_ref<const key_value> find_unique_key(std::string_view name) const {
+      opt_ref<const key_value> output;
+
+      for (const auto& kv: values_) {
+        if (kv.key() == name) {
+          if (output) {
+            throw multiple_definitions_exception{*output, kv, false};
+          }
+          output = kv;
+        }
+      }
+
+      if (output) {
+        output->lookups_.hit();
+      }
+
+      return output;
+    }
+
+
+
+    void find_unique_keys(
+        std::span<const std::string_view>   names,
+        std::span<opt_ref<const key_value>> output
+    ) const {
+      for (const auto& kv: values_) {
+        for (size_t i = 0; i < names.size(); ++i) {
+          if (kv.key() == names[i]) {
+            if (output[i]) {
+              throw multiple_definitions_exception{*output[i], kv, false};
+            }
+            output[i] = kv;
+          }
+        }
+      }
+
+      for (auto& ref: output) {
+        if (ref) {
+          ref->lookups_.hit();
+        }
+      }
+    }
 };
 
 
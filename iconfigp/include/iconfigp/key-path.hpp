@@ -0,0 +1,169 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_KEY_PATH_HPP_INCLUDED
+#define ICONFIGP_KEY_PATH_HPP_INCLUDED
+
+#include "iconfigp/exception.hpp"
+#include "iconfigp/frozen-document.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+// Handle for a key which is looked up repeatedly. The first lookup in a frozen document
+// resolves the path and caches the index of the key together with the generation of
+// the document; further lookups in the same document are O(1). A lookup in a different
+// document (e.g. after a reload) resolves the path again and yields nothing if the key
+// was removed.
+class key_path {
+  public:
+    // "a.b.c" refers to key c in section [a.b], a path without dots to a key of the root
+    explicit key_path(std::string_view path) {
+      auto split = path.rfind('.');
+      if (split == std::string_view::npos) {
+        key_ = path;
+        return;
+      }
+
+      key_ = path.substr(split + 1);
+      path = path.substr(0, split);
+
+      while (true) {
+        auto part = path.substr(0, path.find('.'));
+        sections_.emplace_back(part);
+        if (part.size() == path.size()) {
+          break;
+        }
+        path.remove_prefix(part.size() + 1);
+      }
+    }
+
+    key_path(const key_path& other) :
+      sections_{other.sections_},
+      key_     {other.key_}
+    {}
+
+    key_path(key_path&& other) noexcept :
+      sections_{std::move(other.sections_)},
+      key_     {std::move(other.key_)}
+    {}
+
+    key_path& operator=(const key_path& other) {
+      sections_ = other.sections_;
+      key_      = other.key_;
+      cache_.store(0, std::memory_order_relaxed);
+      return *this;
+    }
+
+    key_path& operator=(key_path&& other) noexcept {
+      sections_ = std::move(other.sections_);
+      key_      = std::move(other.key_);
+      cache_.store(0, std::memory_order_relaxed);
+      return *this;
+    }
+
+    ~key_path() = default;
+
+
+
+    [[nodiscard]] std::span<const std::string> sections() const { return sections_; }
+    [[nodiscard]] std::string_view             key()      const { return key_;      }
+
+
+
+    template<std::unsigned_integral Offset>
+    [[nodiscard]] std::optional<typename basic_frozen_document<Offset>::key_view> resolve(
+        const basic_frozen_document<Offset>& doc
+    ) const {
+      using key_view = typename basic_frozen_document<Offset>::key_view;
+
+      auto cached = cache_.load(std::memory_order_acquire);
+      if (static_cast<uint32_t>(cached >> index_bits) == doc.generation()) {
+        auto index = static_cast<uint32_t>(cached);
+        if (index == missing) {
+          return {};
+        }
+        return key_view{doc, index};
+      }
+
+      auto kv = lookup(doc);
+
+      uint32_t index = missing;
+      if (kv) {
+        if (kv->index() >= missing) {
+          return kv;
+        }
+        index = static_cast<uint32_t>(kv->index());
+      }
+
+      cache_.store((uint64_t{doc.generation()} << index_bits) | index,
+          std::memory_order_release);
+
+      return kv;
+    }
+
+
+
+    template<std::unsigned_integral Offset>
+    [[nodiscard]] typename basic_frozen_document<Offset>::key_view require(
+        const basic_frozen_document<Offset>& doc
+    ) const {
+      if (auto kv = resolve(doc)) {
+        return *kv;
+      }
+
+      auto sec = doc.root();
+      for (const auto& name: sections_) {
+        auto next = sec.subsection(name);
+        if (!next) {
+          break;
+        }
+        sec = *next;
+      }
+
+      throw missing_key_exception{key_, sec.offset()};
+    }
+
+
+
+  private:
+    static constexpr size_t   index_bits = 32;
+    static constexpr uint32_t missing    = UINT32_MAX;
+
+    std::vector<std::string>      sections_;
+    std::string                   key_;
+
+    // generation of the document in the upper, index of the key in the lower half
+    mutable std::atomic<uint64_t> cache_{0};
+
+
+
+    template<std::unsigned_integral Offset>
+    [[nodiscard]] std::optional<typename basic_frozen_document<Offset>::key_view> lookup(
+        const basic_frozen_document<Offset>& doc
+    ) const {
+      auto sec = doc.root();
+      for (const auto& name: sections_) {
+        auto next = sec.subsection(name);
+        if (!next) {
+          return {};
+        }
+        sec = *next;
+      }
+      return sec.unique_key(key_);
+    }
+};
+
+}
+
+#endif // ICONFIGP_KEY_PATH_HPP_INCLUDED
@@ -5,12 +5,24 @@
 #define ICONFIGP_KEY_VALUE_HPP_INCLUDED
 
 #include "iconfigp/located-string.hpp"
+#include "iconfigp/profile.hpp"
+
+#include <concepts>
 
 
 
 namespace iconfigp {
 
+class section;
+
 class key_value {
+  template<std::unsigned_integral> friend class basic_frozen_document;
+  friend class group;
+  friend class parser;
+  friend class schema;
+  friend class section;
+  friend size_t memory_usage(const section&);
+
   public:
     key_value(located_string key, located_string value) :
       key_        {std::move(key)},
@@ -26,10 +38,14 @@ class key_value {
 
     [[nodiscard]] bool             used()         const { return used_;           }
 
+    [[nodiscard]] uint64_t         lookup_count() const { return lookups_.count(); }
+    [[nodiscard]] uint64_t         read_count()   const { return reads_.count();   }
+
     [[nodiscard]] std::string_view key()          const { return key_.content();  }
 
     [[nodiscard]] std::string_view value() const {
       used_ = true;
+      reads_.hit();
       return value_.content();
     }
 
@@ -40,6 +56,9 @@ class key_value {
     located_string value_;
 
     mutable bool   used_{false};
+
+    [[no_unique_address]] access_counter lookups_;
+    [[no_unique_address]] access_counter reads_;
 };
 
 
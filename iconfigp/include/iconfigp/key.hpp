@@ -0,0 +1,74 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_KEY_HPP_INCLUDED
+#define ICONFIGP_KEY_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+
+
+namespace iconfigp {
+
+// 64-bit FNV-1a
+[[nodiscard]] constexpr uint64_t key_hash(std::string_view name) {
+  uint64_t hash{0xcbf29ce484222325};
+
+  for (char c: name) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+
+  return hash;
+}
+
+
+
+// Key name together with its hash. Created from a literal via "name"_key, the hash is
+// computed at compile time.
+class hashed_key {
+  public:
+    constexpr explicit hashed_key(std::string_view name) :
+      name_{name},
+      hash_{key_hash(name)}
+    {}
+
+
+
+    [[nodiscard]] constexpr std::string_view name() const { return name_; }
+    [[nodiscard]] constexpr uint64_t         hash() const { return hash_; }
+
+
+
+  private:
+    std::string_view name_;
+    uint64_t         hash_;
+};
+
+
+
+namespace literals {
+  [[nodiscard]] consteval hashed_key operator""_key(const char* name, size_t size) {
+    return hashed_key{std::string_view{name, size}};
+  }
+}
+
+
+
+namespace detail {
+  // transparent hash, containers of std::string can be searched with a std::string_view
+  struct string_hash {
+    using is_transparent = void;
+
+    [[nodiscard]] size_t operator()(std::string_view str) const {
+      return std::hash<std::string_view>{}(str);
+    }
+  };
+}
+
+}
+
+#endif // ICONFIGP_KEY_HPP_INCLUDED
@@ -0,0 +1,182 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_LAYERED_HPP_INCLUDED
+#define ICONFIGP_LAYERED_HPP_INCLUDED
+
+#include "iconfigp/format.hpp"
+#include "iconfigp/key-value.hpp"
+#include "iconfigp/loader.hpp"
+#include "iconfigp/opt-ref.hpp"
+#include "iconfigp/section.hpp"
+
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+enum class layer_kind {
+  defaults,
+  system,
+  user,
+  environment,
+  overrides,
+};
+
+
+
+struct layer {
+  layer_kind kind;
+  document   doc;
+};
+
+
+
+
+
+// Merged view of one section across all layers of a layered_config. Keys and section
+// names refer to the strings owned by the layers, a lookup costs a single hash lookup.
+class overlay {
+  friend class layered_config;
+
+  public:
+    [[nodiscard]] size_t offset() const { return offset_; }
+
+
+
+    [[nodiscard]] opt_ref<const overlay> subsection(std::string_view name) const {
+      if (auto it = sections_.find(name); it != sections_.end()) {
+        return *it->second;
+      }
+      return {};
+    }
+
+
+
+    [[nodiscard]] opt_ref<const key_value> unique_key(std::string_view name) const {
+      if (const auto* ent = find(name)) {
+        return *ent->value;
+      }
+      return {};
+    }
+
+
+
+    [[nodiscard]] const key_value& require_unique_key(std::string_view name) const {
+      if (auto ref = unique_key(name)) {
+        return *ref;
+      }
+      throw missing_key_exception{std::string{name}, offset_};
+    }
+
+
+
+    // index of the layer which provides the key
+    [[nodiscard]] std::optional<size_t> layer_of(std::string_view name) const {
+      if (const auto* ent = find(name)) {
+        return ent->layer;
+      }
+      return {};
+    }
+
+
+
+
+
+  private:
+    struct entry {
+      const key_value* value;
+      const key_value* conflict;
+      bool             per_section;
+      size_t           layer;
+    };
+
+    size_t                                                         offset_{0};
+    std::unordered_map<std::string_view, entry>                    keys_;
+    std::unordered_map<std::string_view, std::unique_ptr<overlay>> sections_;
+
+
+
+    [[nodiscard]] const entry* find(std::string_view name) const {
+      auto it = keys_.find(name);
+      if (it == keys_.end()) {
+        return nullptr;
+      }
+
+      if (it->second.conflict != nullptr) {
+        throw multiple_definitions_exception{*it->second.value, *it->second.conflict,
+          it->second.per_section};
+      }
+
+      return &it->second;
+    }
+
+
+
+    void add(const section&, size_t);
+};
+
+
+
+
+
+// Configuration assembled from several layers, where keys of later layers override the
+// same keys of earlier layers. All layers share one offset space, i.e., exceptions can be
+// formatted with sources(). If adding a layer fails, the layer is not added, but sources()
+// still contains the files of the failed layer.
+class layered_config {
+  public:
+    // defaults, all system config files, the user config file, environment overrides
+    // (see find_environment_overrides), and overrides (if not empty)
+    [[nodiscard]] static layered_config load(
+        std::string_view /*name*/,
+        std::string      /*defaults*/  = {},
+        std::string      /*overrides*/ = {}
+    );
+
+
+
+    void add_file  (layer_kind, const std::filesystem::path&);
+    void add_string(layer_kind, std::string /*content*/, std::string /*name*/);
+
+    // adds a layer of kind environment if any overrides are found
+    void add_environment(std::string_view /*name*/);
+
+
+
+    [[nodiscard]] const overlay&               root()        const { return root_;          }
+
+    [[nodiscard]] size_t                       layer_count() const { return layers_.size(); }
+    [[nodiscard]] const layer&                 layer_at(size_t index) const {
+      return layers_.at(index);
+    }
+
+    [[nodiscard]] std::span<const source_file> sources()     const { return sources_;       }
+
+
+
+  private:
+    std::deque<layer>        layers_;
+    std::deque<document>     failed_; // kept alive for sources()
+    overlay                  root_;
+    std::vector<source_file> sources_;
+    size_t                   end_offset_{0};
+
+
+
+    void push(layer_kind, const std::function<void(document&, size_t)>&);
+};
+
+}
+
+#endif // ICONFIGP_LAYERED_HPP_INCLUDED
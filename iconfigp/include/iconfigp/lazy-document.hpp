@@ -0,0 +1,76 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_LAZY_DOCUMENT_HPP_INCLUDED
+#define ICONFIGP_LAZY_DOCUMENT_HPP_INCLUDED
+
+#include "iconfigp/opt-ref.hpp"
+#include "iconfigp/section.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+// Document which only locates the section headers of its input up front. A top-level
+// section (including all of its subsections) is parsed on its first access, the result
+// is the same as the corresponding subsection of parser::parse(input). Keys and values
+// outside of section headers are skipped without decoding them, syntax errors within
+// them may therefore only be reported on first access. input has to outlive the document.
+class lazy_document {
+  public:
+    explicit lazy_document(std::string_view input, size_t base_offset = 0);
+
+
+
+    // groups and includes of the root section, subsections are only available through
+    // subsection()
+    [[nodiscard]] const section& root() const { return materialize(entries_.front()); }
+
+    [[nodiscard]] opt_ref<const section> subsection(std::string_view name) const;
+
+    // top-level sections in order of appearance
+    [[nodiscard]] std::vector<std::string_view> section_names() const;
+
+    [[nodiscard]] bool materialized(std::string_view name) const;
+
+
+
+  private:
+    struct range {
+      size_t begin;
+      size_t end;
+    };
+
+    struct entry {
+      std::string                    name;
+      std::vector<range>             ranges; // header to next header, relative to input
+
+      mutable std::once_flag         once;
+      mutable std::optional<section> content;
+      mutable std::atomic<bool>      done{false};
+    };
+
+    std::string_view                             input_;
+    size_t                                       base_offset_;
+
+    std::vector<entry>                           entries_; // the root section comes first
+    std::unordered_map<std::string_view, size_t> index_;
+
+
+
+    [[nodiscard]] const section& materialize(const entry& ent) const;
+    [[nodiscard]] section        parse_ranges(std::span<const range> ranges) const;
+};
+
+}
+
+#endif // ICONFIGP_LAZY_DOCUMENT_HPP_INCLUDED
@@ -0,0 +1,57 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_LOADER_HPP_INCLUDED
+#define ICONFIGP_LOADER_HPP_INCLUDED
+
+#include "iconfigp/format.hpp"
+#include "iconfigp/section.hpp"
+
+#include <deque>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+// A config file together with all files it (transitively) includes via @include.
+// The contents of all files are kept alive by the document, each file occupies its own
+// range of offsets which sources() maps back to the file.
+class document {
+  public:
+    // Load path and resolve its includes relative to the including file. Included files
+    // are read and parsed concurrently and only once, even if included multiple times.
+    // On error, sources() contains all files read so far to format the exception.
+    void load(const std::filesystem::path&, size_t /*base_offset*/ = 0);
+
+    // Load content as if it was read from a file called name. Relative includes are
+    // resolved relative to the current working directory.
+    void load_string(std::string /*content*/, std::string /*name*/, size_t /*base_offset*/ = 0);
+
+
+
+    [[nodiscard]] const section&               root()       const { return root_;       }
+    [[nodiscard]] std::span<const source_file> sources()    const { return sources_;    }
+
+    // first offset not used by any file of this document
+    [[nodiscard]] size_t                       end_offset() const { return end_offset_; }
+
+
+
+  private:
+    class loader;
+
+    section                  root_{"", 0};
+
+    std::deque<std::string>  contents_;
+    std::vector<source_file> sources_;
+
+    size_t                   end_offset_{0};
+};
+
+}
+
+#endif // ICONFIGP_LOADER_HPP_INCLUDED
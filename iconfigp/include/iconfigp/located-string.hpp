@@ -4,43 +4,225 @@
 #ifndef ICONFIGP_LOCATED_STRING_HPP_INCLUDED
 #define ICONFIGP_LOCATED_STRING_HPP_INCLUDED
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 
 namespace iconfigp {
 
+class section;
+
 class located_string {
+  friend class reader;
+  friend class string_pool;
+  friend size_t memory_usage(const section&);
+
   public:
     located_string(std::string content, size_t offset, size_t size) :
-      content_{std::move(content)},
-      offset_ {offset},
-      size_   {size}
+      owned_ {std::move(content)},
+      offset_{offset},
+      size_  {tagged(kind::owned, size)}
     {}
 
     explicit located_string(std::string content) :
-      content_{std::move(content)},
-      offset_ {0},
-      size_   {content_.size()}
+      owned_ {std::move(content)},
+      offset_{0},
+      size_  {tagged(kind::owned, owned_.size())}
     {}
 
+    located_string(const located_string& other) :
+      offset_{other.offset_},
+      size_  {other.size_}
+    {
+      switch (other.get_kind()) {
+        case kind::owned:
+          std::construct_at(&owned_, other.owned_);
+          break;
+        case kind::view:
+        case kind::pooled:
+          std::construct_at(&view_, other.view_);
+          break;
+        case kind::lazy:
+          std::construct_at(&lazy_, new lazy_token{other.lazy_->raw});
+          break;
+      }
+    }
+
+    located_string(located_string&& other) noexcept :
+      offset_{other.offset_},
+      size_  {other.size_}
+    {
+      take(std::move(other));
+    }
+
+    located_string& operator=(const located_string& other) {
+      if (this != &other) {
+        *this = located_string{other};
+      }
+      return *this;
+    }
+
+    located_string& operator=(located_string&& other) noexcept {
+      if (this != &other) {
+        destroy();
+        offset_ = other.offset_;
+        size_   = other.size_;
+        take(std::move(other));
+      }
+      return *this;
+    }
+
+    ~located_string() {
+      destroy();
+    }
+
+
+
+    [[nodiscard]] bool operator==(const located_string& other) const {
+      return offset_ == other.offset_ && size() == other.size() && same_content(other);
+    }
+
+    // strings interned in the same pool are compared by address
+    [[nodiscard]] bool same_content(const located_string& other) const {
+      return (interned() && other.interned() && view_.data() == other.view_.data()
+                && view_.size() == other.view_.size()) || content() == other.content();
+    }
+
+
+
+    [[nodiscard]] std::string_view content()     const {
+      switch (get_kind()) {
+        case kind::owned:  return owned_;
+        case kind::view:
+        case kind::pooled: return view_;
+        case kind::lazy:   return decode();
+      }
+      return {};
+    }
+    [[nodiscard]] size_t           offset()      const { return offset_;  }
+    [[nodiscard]] size_t           size()        const { return size_ & size_mask; }
 
+    [[nodiscard]] bool             interned()    const { return get_kind() == kind::pooled; }
 
-    [[nodiscard]] bool operator==(const located_string&) const = default;
-
-
-
-    [[nodiscard]] std::string_view content()     const { return content_; }
-    [[nodiscard]] size_t           offset()      const { return offset_;  }
-    [[nodiscard]] size_t           size()        const { return size_;    }
+    // false until the content of a lazily parsed string is accessed
+    [[nodiscard]] bool             decoded()     const {
+      return get_kind() != kind::lazy || lazy_->done.load(std::memory_order_acquire);
+    }
 
-    [[nodiscard]] std::string take_string() && { return std::move(content_); }
+    [[nodiscard]] std::string take_string() && {
+      if (get_kind() == kind::owned) {
+        return std::move(owned_);
+      }
+      return std::string{content()};
+    }
 
 
 
   private:
-    std::string content_;
-    size_t      offset_;
-    size_t      size_;
+    enum class kind : uint8_t {
+      owned,  // owned_ is the content
+      view,   // view_ is the content, it refers to the input
+      pooled, // view_ is the content, it refers to a string in a string_pool
+      lazy,   // lazy_->raw is the token in the input, decoded on first access
+    };
+
+    // token with quotation marks or escape sequences, only allocated for lazily parsed
+    // strings which need decoding
+    struct lazy_token {
+      std::string_view  raw;
+      std::once_flag    once;
+      std::atomic<bool> done{false};
+      std::string       decoded;
+
+      explicit lazy_token(std::string_view token) :
+        raw{token}
+      {}
+    };
+
+    // the kind is stored in the two highest bits of size_, which keeps eagerly parsed
+    // strings as small as a std::string and two offsets
+    static constexpr size_t kind_shift = std::numeric_limits<size_t>::digits - 2;
+    static constexpr size_t size_mask  = (size_t{1} << kind_shift) - 1;
+
+    union {
+      std::string      owned_;
+      std::string_view view_;
+      lazy_token*      lazy_;
+    };
+
+    size_t offset_;
+    size_t size_;
+
+
+
+    located_string(const std::string* pooled, size_t offset, size_t size) :
+      view_  {*pooled},
+      offset_{offset},
+      size_  {tagged(kind::pooled, size)}
+    {}
+
+    // refers to input instead of owning its content
+    located_string(std::string_view raw, bool verbatim, size_t offset, size_t size) :
+      offset_{offset},
+      size_  {tagged(verbatim ? kind::view : kind::lazy, size)}
+    {
+      if (verbatim) {
+        std::construct_at(&view_, raw);
+      } else {
+        std::construct_at(&lazy_, new lazy_token{raw});
+      }
+    }
+
+
+
+    [[nodiscard]] static size_t tagged(kind k, size_t size) {
+      return (static_cast<size_t>(k) << kind_shift) | size;
+    }
+
+    [[nodiscard]] kind get_kind() const {
+      return static_cast<kind>(size_ >> kind_shift);
+    }
+
+
+
+    // expects the storage of this to be uninitialized and size_ to be set
+    void take(located_string&& other) noexcept {
+      switch (get_kind()) {
+        case kind::owned:
+          std::construct_at(&owned_, std::move(other.owned_));
+          break;
+        case kind::view:
+        case kind::pooled:
+          std::construct_at(&view_, other.view_);
+          break;
+        case kind::lazy:
+          // other is left as an empty view
+          std::construct_at(&lazy_, other.lazy_);
+          std::construct_at(&other.view_);
+          other.size_ = tagged(kind::view, other.size());
+          break;
+      }
+    }
+
+    void destroy() noexcept {
+      switch (get_kind()) {
+        case kind::owned:  std::destroy_at(&owned_); break;
+        case kind::view:
+        case kind::pooled:                           break;
+        case kind::lazy:   delete lazy_;             break;
+      }
+    }
+
+
+
+    [[nodiscard]] std::string_view decode() const;
+
+    // heap memory owned by this string, interned strings are owned by the pool
+    [[nodiscard]] size_t heap_size() const;
 };
 
 }
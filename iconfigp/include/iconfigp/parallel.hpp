@@ -0,0 +1,52 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_PARALLEL_HPP_INCLUDED
+#define ICONFIGP_PARALLEL_HPP_INCLUDED
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+
+
+namespace iconfigp::detail {
+
+// Calls process(begin, end) for consecutive ranges covering [0, count). If parallel is
+// set, the ranges are processed on separate threads, but each of them has at least
+// min_chunk items since below that, spawning threads costs more than it saves.
+// Exceptions thrown by process are rethrown once all ranges are done.
+template<std::invocable<size_t, size_t> Process>
+void for_each_chunk(size_t count, size_t min_chunk, bool parallel, Process&& process) {
+  size_t threads = parallel ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : 1;
+  threads = std::min(threads, std::max<size_t>(1, count / min_chunk));
+
+  if (threads <= 1) {
+    process(size_t{0}, count);
+    return;
+  }
+
+  // the first count % threads ranges get one more item
+  auto bound = [base = count / threads, extra = count % threads](size_t index) {
+    return index * base + std::min(index, extra);
+  };
+
+  std::vector<std::future<void>> tasks;
+  for (size_t index = 1; index < threads; ++index) {
+    tasks.push_back(std::async(std::launch::async, [&process, first = bound(index),
+        last = bound(index + 1)]() { process(first, last); }));
+  }
+
+  process(size_t{0}, bound(1));
+
+  for (auto& task: tasks) {
+    task.get();
+  }
+}
+
+}
+
+#endif // ICONFIGP_PARALLEL_HPP_INCLUDED
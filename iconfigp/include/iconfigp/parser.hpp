@@ -5,39 +5,176 @@
 #define ICONFIGP_PARSER_HPP_INCLUDED
 
 #include "iconfigp/exception.hpp"
+#include "iconfigp/generator.hpp"
 #include "iconfigp/reader.hpp"
 #include "iconfigp/section.hpp"
+#include "iconfigp/stats.hpp"
+#include "iconfigp/string-pool.hpp"
+#include "iconfigp/trace.hpp"
 
+#include <chrono>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
+#include <vector>
 
 
 
 namespace iconfigp {
 
+// a section header selects the section for all following events
+struct section_event {
+  std::vector<std::string> path;
+  size_t                   offset;
+};
+
+// - starts a new group in the current section
+struct group_event {
+  size_t offset;
+};
+
+struct include_event {
+  located_string path;
+};
+
+using parse_event = std::variant<section_event, group_event, include_event, key_value>;
+
+
+
+// lazy: values only refer to their token in the input and are decoded on first access
+enum class value_decoding {
+  eager,
+  lazy,
+};
+
+
+
 class parser {
+  friend class lazy_document;
+  friend class push_parser;
+
   public:
     [[nodiscard]] static section parse(std::string_view input) {
-      parser p{input};
+      return parse(input, 0);
+    }
+
+    // all offsets in the resulting tree (and in syntax errors) start at base_offset
+    [[nodiscard]] static section parse(std::string_view input, size_t base_offset) {
+      ICONFIGP_TRACE(parse__start, input.data(), input.size());
+
+      parser p{input, base_offset};
+      p.parse_input();
+
+      ICONFIGP_TRACE(parse__end, input.data(), input.size());
+      return std::move(p.root_);
+    }
+
+    // keys and values are interned in pool, which has to outlive the resulting tree
+    [[nodiscard]] static section parse(
+        std::string_view input,
+        string_pool&     pool,
+        size_t           base_offset = 0
+    ) {
+      ICONFIGP_TRACE(parse__start, input.data(), input.size());
+
+      parser p{input, base_offset};
+      p.pool_ = &pool;
+      p.parse_input();
+
+      ICONFIGP_TRACE(parse__end, input.data(), input.size());
+      return std::move(p.root_);
+    }
+
+    // with lazy decoding, input has to outlive the resulting tree
+    [[nodiscard]] static section parse(
+        std::string_view input,
+        value_decoding   decoding,
+        size_t           base_offset = 0
+    ) {
+      ICONFIGP_TRACE(parse__start, input.data(), input.size());
+
+      parser p{input, base_offset};
+      p.decoding_ = decoding;
+      p.parse_input();
+
+      ICONFIGP_TRACE(parse__end, input.data(), input.size());
+      return std::move(p.root_);
+    }
+
+    [[nodiscard]] static section parse(std::string_view input, parse_stats& stats) {
+      using clock = std::chrono::steady_clock;
+
+      ICONFIGP_TRACE(parse__start, input.data(), input.size());
+
+      auto start = clock::now();
+
+      parser p{input, 0};
+      p.stats_ = &stats;
       p.parse_input();
+
+      auto total = clock::now() - start;
+
+      ICONFIGP_TRACE(parse__end, input.data(), input.size());
+
+      stats.bytes_scanned += input.size();
+      stats.escapes       += p.reader_.escapes();
+      stats.quotes        += p.reader_.quotes();
+      stats.reader_time   += std::chrono::duration_cast<std::chrono::nanoseconds>(total)
+                               - p.tree_time_;
+      stats.tree_time     += p.tree_time_;
+
+      count_nodes(p.root_, stats);
+      stats.tree_bytes    += memory_usage(p.root_);
+
       return std::move(p.root_);
     }
 
 
 
+    // syntactical elements of input in order of appearance, without building a tree;
+    // input has to outlive the generator
+    [[nodiscard]] static generator<parse_event> events(
+        std::string_view input,
+        size_t           base_offset = 0
+    ) {
+      parser p{input, base_offset};
+
+      while (auto event = p.next_event()) {
+        co_yield std::move(*event);
+      }
+    }
+
+
+
   private:
-    reader    reader_;
-    task_type task_  {task_type::toplevel};
-    section   root_  {"", 0};
+    reader                   reader_;
+    task_type                task_     {task_type::toplevel};
+    section                  root_;
+
+    parse_stats*             stats_    {nullptr};
+    std::chrono::nanoseconds tree_time_{0};
+
+    string_pool*             pool_     {nullptr};
+    value_decoding           decoding_ {value_decoding::eager};
 
 
 
-    explicit parser(std::string_view input) :
-      reader_{input}
+    parser(std::string_view input, size_t base_offset) :
+      reader_{input, base_offset},
+      root_  {"", base_offset}
     {}
 
 
 
+    // continue parsing the same tree on new input
+    void reset(std::string_view input, size_t base_offset) {
+      reader_ = reader{input, base_offset};
+    }
+
+
+
     void task(task_type type) {
       task_ = type;
       reader_.task(type);
@@ -57,28 +194,148 @@ class parser {
 
 
 
+    template<typename Fn>
+    void build(Fn&& fn) {
+      if (stats_ == nullptr) {
+        std::forward<Fn>(fn)();
+        return;
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      std::forward<Fn>(fn)();
+      tree_time_ += std::chrono::steady_clock::now() - start;
+    }
+
+
+
+    static void count_nodes(const section& sec, parse_stats& stats) {
+      for (const auto& grp: sec.groups_) {
+        if (!grp.empty()) {
+          stats.groups++;
+          stats.keys += grp.entries().size();
+        }
+      }
+
+      for (const auto& subsec: sec.sections_) {
+        stats.sections++;
+        count_nodes(subsec, stats);
+      }
+    }
+
+
+
+
+
     void parse_input() {
-      task(task_type::toplevel);
+      while (auto event = next_event()) {
+        build([&] { std::visit([this](auto&& ev) { apply(std::move(ev)); }, *event); });
+      }
+    }
+
+
+
+    void apply(section_event&& event) {
+      root_.select_section(event.path, event.offset);
+    }
+
+    void apply(group_event&& event) {
+      root_.new_group(event.offset);
+    }
+
+    void apply(include_event&& event) {
+      root_.include(std::move(event.path));
+    }
 
+    void apply(key_value&& event) {
+      if (pool_ != nullptr) {
+        event.key_   = pool_->intern(std::move(event.key_));
+        event.value_ = pool_->intern(std::move(event.value_));
+      }
+      root_.append(std::move(event));
+    }
+
+
+
+
+
+    [[nodiscard]] std::optional<parse_event> next_event() {
+      task(task_type::toplevel);
       reader_.skip_ignored();
 
-      while (!reader_.eof()) {
+      if (reader_.eof()) {
+        return {};
+      }
+
+      if (reader_.peek() == '[') {
+        return parse_section();
+      }
+
+      if (reader_.peek() == '-') {
+        group_event event{reader_.offset()};
+        reader_.skip();
+        return event;
+      }
+
+      if (reader_.peek() == ';') {
+        raise_error(syntax_error_type::unexpected_semicolon);
+      }
+
+      if (at_include_directive()) {
+        return parse_include();
+      }
+
+      return parse_key_value();
+    }
+
+
+
+
+
+    // skips all elements up to the next section header without decoding them, returns
+    // false at the end of the input
+    [[nodiscard]] bool skip_to_section() {
+      while (true) {
+        task(task_type::toplevel);
+        reader_.skip_ignored();
+
+        if (reader_.eof()) {
+          return false;
+        }
+
         if (reader_.peek() == '[') {
-          parse_section();
+          return true;
+        }
 
-        } else if (reader_.peek() == '-') {
-          root_.new_group(reader_.offset());
+        if (reader_.peek() == '-') {
           reader_.skip();
+          continue;
+        }
 
-        } else if (reader_.peek() == ';') {
+        if (reader_.peek() == ';') {
           raise_error(syntax_error_type::unexpected_semicolon);
+        }
+
+        if (at_include_directive()) {
+          task(task_type::include);
+          reader_.skip(include_directive.size());
+          reader_.skip_until_one_of("\n;[");
 
         } else {
-          parse_key_value();
+          task(task_type::key);
+          reader_.skip_until_one_of("=;\n");
+
+          if (reader_.eof() || reader_.peek() != '=') {
+            raise_error(syntax_error_type::missing_value);
+          }
+          reader_.skip();
+
+          task(task_type::value);
+          reader_.skip_until_one_of("\n;[");
         }
 
-        task(task_type::toplevel);
-        reader_.skip_ignored();
+        if (!reader_.eof() && reader_.peek() == ';') {
+          reader_.skip();
+        }
       }
     }
 
@@ -86,7 +343,7 @@ class parser {
 
 
 
-    void parse_section() {
+    [[nodiscard]] section_event parse_section() {
       task(task_type::section);
 
       auto section_start = reader_.offset();
@@ -102,12 +359,51 @@ class parser {
       }
       reader_.skip();
 
-      root_.select_section(section_path, section_start);
+      size_t depth = std::ranges::find_if(section_path,
+          [](const auto& name) { return name.empty(); }) - section_path.begin();
+
+      ICONFIGP_TRACE(section__header, section_start, depth);
+
+      if (stats_ != nullptr) {
+        stats_->max_depth = std::max(stats_->max_depth, depth);
+      }
+
+      return section_event{std::move(section_path), section_start};
+    }
+
+
+
+    static constexpr std::string_view include_directive{"@include"};
+
+    [[nodiscard]] bool at_include_directive() const {
+      auto remaining = reader_.remaining();
+      return remaining.starts_with(include_directive) &&
+        (remaining.size() == include_directive.size() ||
+         is_space(remaining[include_directive.size()]));
+    }
+
+
+
+    [[nodiscard]] include_event parse_include() {
+      task(task_type::include);
+      reader_.skip(include_directive.size());
+
+      auto path = reader_.read_until_one_of("\n;[");
+
+      if (path.content().empty()) {
+        raise_error(syntax_error_type::empty_include, path.offset());
+      }
+
+      if (!reader_.eof() && reader_.peek() == ';') {
+        reader_.skip();
+      }
+
+      return include_event{std::move(path)};
     }
 
 
 
-    void parse_key_value() {
+    [[nodiscard]] key_value parse_key_value() {
       task(task_type::key);
       auto key = reader_.read_until_one_of("=;\n");
 
@@ -122,13 +418,14 @@ class parser {
       reader_.skip();
 
       task(task_type::value);
-      auto value = reader_.read_until_one_of("\n;[");
+      auto value = decoding_ == value_decoding::lazy ?
+        reader_.read_raw_until_one_of("\n;[") : reader_.read_until_one_of("\n;[");
 
       if (!reader_.eof() && reader_.peek() == ';') {
         reader_.skip();
       }
 
-      root_.append(std::move(key), std::move(value));
+      return key_value{std::move(key), std::move(value)};
     }
 };
 
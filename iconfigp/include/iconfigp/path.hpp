@@ -7,6 +7,9 @@
 #include "iconfigp/value-parser.hpp"
 
 #include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
 
 
 
@@ -29,6 +32,52 @@ void preferred_root_path(const std::filesystem::path&);
 
 [[nodiscard]] std::optional<std::filesystem::path> preferred_root_path();
 
+
+
+// resolve input the same way as value_parser<std::filesystem::path>, but relative to root
+// instead of the preferred root path
+[[nodiscard]] std::filesystem::path resolve_path(
+    std::string_view,
+    const std::optional<std::filesystem::path>& /*root*/
+);
+
+
+
+// Resolves paths like resolve_path, but captures HOME, the working directory and the root
+// once and checks for existence relative to an open directory handle of the root, i.e.,
+// resolving a path costs at most one faccessat call.
+class path_resolver {
+  public:
+    // uses the preferred root path
+    path_resolver();
+    explicit path_resolver(std::optional<std::filesystem::path> /*root*/);
+
+    path_resolver(const path_resolver&) = delete;
+    path_resolver(path_resolver&&) noexcept;
+    path_resolver& operator=(const path_resolver&) = delete;
+    path_resolver& operator=(path_resolver&&) noexcept;
+
+    ~path_resolver();
+
+
+
+    [[nodiscard]] std::filesystem::path resolve(std::string_view) const;
+
+    // resolve all inputs, if parallel is set the existence checks are split across threads
+    [[nodiscard]] std::vector<std::filesystem::path> resolve(
+        std::span<const std::string_view>,
+        bool /*parallel*/ = false
+    ) const;
+
+
+
+  private:
+    std::optional<std::filesystem::path> home_;
+    std::filesystem::path                cwd_;
+    std::optional<std::filesystem::path> root_;
+    int                                  root_fd_{-1};
+};
+
 }
 
 #endif // ICONFIGP_PATH_HPP_INCLUDED
@@ -0,0 +1,145 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_PROFILE_HPP_INCLUDED
+#define ICONFIGP_PROFILE_HPP_INCLUDED
+
+// Access profiling is only compiled in if the library is configured with
+// -Dprofiling=true, otherwise all counters are empty and report zero.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+class  section;
+struct access_entry;
+
+
+
+namespace detail {
+  [[nodiscard]] bool latency_enabled();
+  void record_latency(std::chrono::nanoseconds);
+
+  void collect_accesses(const section&, const std::string&, std::vector<access_entry>&);
+}
+
+
+
+class access_counter {
+  public:
+    access_counter() = default;
+
+#if defined(ICONFIGP_PROFILING)
+    access_counter(const access_counter& other) :
+      count_{other.count()}
+    {}
+
+    access_counter(access_counter&& other) noexcept :
+      count_{other.count()}
+    {}
+
+    access_counter& operator=(const access_counter& other) {
+      count_.store(other.count(), std::memory_order_relaxed);
+      return *this;
+    }
+
+    access_counter& operator=(access_counter&& other) noexcept {
+      count_.store(other.count(), std::memory_order_relaxed);
+      return *this;
+    }
+
+    ~access_counter() = default;
+
+
+
+    void hit() const { count_.fetch_add(1, std::memory_order_relaxed); }
+
+    [[nodiscard]] uint64_t count() const {
+      return count_.load(std::memory_order_relaxed);
+    }
+
+
+
+  private:
+    mutable std::atomic<uint64_t> count_{0};
+#else
+    void hit() const {}
+
+    [[nodiscard]] uint64_t count() const { return 0; }
+#endif
+};
+
+
+
+class access_timer {
+  public:
+#if defined(ICONFIGP_PROFILING)
+    access_timer() {
+      if (detail::latency_enabled()) {
+        start_ = std::chrono::steady_clock::now();
+      }
+    }
+
+    access_timer(const access_timer&) = delete;
+    access_timer(access_timer&&)      = delete;
+    access_timer& operator=(const access_timer&) = delete;
+    access_timer& operator=(access_timer&&)      = delete;
+
+    ~access_timer() {
+      if (start_ != std::chrono::steady_clock::time_point{}) {
+        detail::record_latency(std::chrono::steady_clock::now() - start_);
+      }
+    }
+
+
+
+  private:
+    std::chrono::steady_clock::time_point start_{};
+#endif
+};
+
+
+
+
+
+void enable_latency_histogram(bool = true);
+void reset_latency_histogram();
+
+// bucket i counts lookups which took [2^i, 2^(i + 1)) nanoseconds
+static constexpr size_t latency_buckets = 32;
+
+[[nodiscard]] std::array<uint64_t, latency_buckets> latency_histogram();
+
+
+
+
+
+// for keys, lookups counts unique_key hits and reads counts value() calls;
+// for sections, lookups counts subsection() hits and reads counts key lookups in it
+struct access_entry {
+  std::string      path;
+  std::string_view key;     // empty for section entries
+  size_t           offset;
+
+  uint64_t         lookups;
+  uint64_t         reads;
+};
+
+// all accessed keys and sections below the section sorted by access count,
+// truncated to the given limit unless it is 0
+[[nodiscard]] std::vector<access_entry> access_report(const section&, size_t = 0);
+
+[[nodiscard]] std::string format_access_report(std::span<const access_entry>);
+
+}
+
+#endif // ICONFIGP_PROFILE_HPP_INCLUDED
@@ -0,0 +1,54 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_PUSH_PARSER_HPP_INCLUDED
+#define ICONFIGP_PUSH_PARSER_HPP_INCLUDED
+
+#include "iconfigp/parser.hpp"
+#include "iconfigp/section.hpp"
+
+#include <span>
+#include <string>
+
+
+
+namespace iconfigp {
+
+// Parser for input which arrives in chunks, e.g. from a pipe or a socket. Complete
+// elements are added to the tree as soon as they are fed, only the element at the end of
+// the data is buffered: an element (or syntax error) which reaches the end of the buffer
+// might continue in the next chunk and is parsed again once it arrives.
+class push_parser {
+  public:
+    // all offsets in the resulting tree (and in syntax errors) start at base_offset
+    explicit push_parser(size_t base_offset = 0) :
+      parser_{{}, base_offset},
+      offset_{base_offset}
+    {}
+
+
+
+    void feed(std::span<const char> chunk);
+
+    // parses the remaining buffer, the push_parser must not be used afterwards
+    [[nodiscard]] section finish();
+
+
+
+    [[nodiscard]] size_t buffered() const { return buffer_.size(); }
+
+
+
+  private:
+    parser      parser_;
+    std::string buffer_;
+    size_t      offset_; // offset of the start of buffer_
+
+
+
+    void drain(bool final);
+};
+
+}
+
+#endif // ICONFIGP_PUSH_PARSER_HPP_INCLUDED
@@ -17,9 +17,10 @@ namespace iconfigp {
 
 class reader {
   public:
-    explicit reader(std::string_view source) :
+    explicit reader(std::string_view source, size_t base_offset = 0) :
       source_{source},
-      start_ {source.data()}
+      start_ {source.data()},
+      base_  {base_offset}
     {}
 
 
@@ -32,13 +33,16 @@ class reader {
 
 
 
-    [[nodiscard]] const char*      ptr()       const { return source_.data();  }
-    [[nodiscard]] size_t           offset()    const { return ptr() - start_;  }
-    [[nodiscard]] bool             eof()       const { return source_.empty(); }
-    [[nodiscard]] char             peek()      const { return source_.front(); }
+    [[nodiscard]] const char*      ptr()       const { return source_.data();         }
+    [[nodiscard]] size_t           offset()    const { return ptr() - start_ + base_; }
+    [[nodiscard]] bool             eof()       const { return source_.empty();        }
+    [[nodiscard]] char             peek()      const { return source_.front();        }
 
     [[nodiscard]] std::string_view remaining() const { return source_; }
 
+    [[nodiscard]] size_t           escapes()   const { return escapes_;   }
+    [[nodiscard]] size_t           quotes()    const { return quotes_;    }
+
 
 
     void skip(size_t count = 1) {
@@ -73,6 +77,7 @@ class reader {
             raise_exception(syntax_error_type::invalid_escape_sequence, offset() - 1);
           }
           skip();
+          ++escapes_;
         } else if (peek() == '\'' || peek() == '"') {
           auto start = offset();
           std::ignore = read_up_until_closing_quotation_mark();
@@ -95,6 +100,57 @@ class reader {
 
 
 
+    // same as read_until_one_of, but without decoding the content
+    void skip_until_one_of(std::string_view controls) {
+      skip_whitespace_within_line();
+
+      if (eof() || (peek() != '"' && peek() != '\'')) {
+        std::ignore = skip_escaped_until_one_of(controls);
+        return;
+      }
+
+      skip_quoted();
+
+      skip_whitespace_within_line();
+      assert_peek_is_one_of(controls);
+    }
+
+
+
+    // same as read_until_one_of, but the result refers to the token in the input, which
+    // is only decoded on first access; the input has to outlive the result
+    [[nodiscard]] located_string read_raw_until_one_of(std::string_view controls) {
+      skip_whitespace_within_line();
+
+      auto        start = offset();
+      const char* begin = ptr();
+
+      if (eof() || (peek() != '"' && peek() != '\'')) {
+        auto end = skip_escaped_until_one_of(controls);
+
+        std::string_view raw{begin, ptr() == begin ? 0 : end - start};
+        return located_string{raw, raw.find('\\') == std::string_view::npos,
+                              start, end - start};
+      }
+
+      bool single = peek() == '\'';
+      skip_quoted();
+
+      size_t           size = offset() - start;
+      std::string_view raw{begin, size};
+
+      skip_whitespace_within_line();
+      assert_peek_is_one_of(controls);
+
+      if (single || raw.find('\\') == std::string_view::npos) {
+        return located_string{raw.substr(1, size - 2), true, start, size};
+      }
+
+      return located_string{raw, false, start, size};
+    }
+
+
+
     [[nodiscard]] located_string read_until_one_of(std::string_view controls) {
       skip_whitespace_within_line();
 
@@ -102,7 +158,7 @@ class reader {
 
 
 
-      if (peek() != '"' && peek() != '\'') {
+      if (eof() || (peek() != '"' && peek() != '\'')) {
         auto [content, end] = read_escaped_until_one_of(controls);
 
         while (!content.empty() && is_space(content.back())) {
@@ -139,8 +195,12 @@ class reader {
   private:
     std::string_view source_;
     const char*      start_;
+    size_t           base_;
     task_type        task_  {task_type::toplevel};
 
+    size_t           escapes_{0};
+    size_t           quotes_ {0};
+
 
 
     [[noreturn]] void raise_exception(syntax_error_type error, size_t off) const {
@@ -179,6 +239,52 @@ class reader {
 
 
 
+    // returns the offset after the last character which is not whitespace
+    [[nodiscard]] size_t skip_escaped_until_one_of(std::string_view controls) {
+      auto last_non_whitespace = offset();
+
+      for (; !eof() && controls.find(peek()) == std::string_view::npos; skip()) {
+        if (peek() == '\\') {
+          skip();
+          if (eof()) {
+            raise_exception(syntax_error_type::invalid_escape_sequence, offset() - 1);
+          }
+          last_non_whitespace = offset();
+        } else if (!is_space(peek())) {
+          last_non_whitespace = offset();
+        }
+      }
+
+      return last_non_whitespace + 1;
+    }
+
+
+
+    void skip_quoted() {
+      auto start = offset();
+
+      if (peek() == '"') {
+        skip();
+        std::ignore = skip_escaped_until_one_of("\"\n");
+      } else {
+        skip();
+        while (!eof() && peek() != '\'' && peek() != '\n') {
+          skip();
+        }
+      }
+
+      if (eof()) {
+        raise_exception(syntax_error_type::missing_quotation_mark, start);
+      }
+      if (peek() == '\n') {
+        raise_exception(syntax_error_type::missing_quotation_mark_eol, start);
+      }
+
+      skip();
+    }
+
+
+
     [[nodiscard]] std::pair<std::string, size_t> read_escaped_until_one_of(
         std::string_view controls
     ) {
@@ -200,6 +306,7 @@ class reader {
           raise_exception(syntax_error_type::invalid_escape_sequence, offset() - 1);
         }
 
+        ++escapes_;
         if (peek() == 'n') {
           content.push_back('\n');
         } else {
@@ -215,6 +322,8 @@ class reader {
 
 
     [[nodiscard]] std::string read_up_until_closing_quotation_mark() {
+      ++quotes_;
+
       if (peek() == '"') {
         skip();
         return std::move(read_escaped_until_one_of("\"\n").first);
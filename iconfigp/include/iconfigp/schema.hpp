@@ -0,0 +1,138 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_SCHEMA_HPP_INCLUDED
+#define ICONFIGP_SCHEMA_HPP_INCLUDED
+
+#include "iconfigp/exception.hpp"
+#include "iconfigp/key.hpp"
+#include "iconfigp/key-value.hpp"
+#include "iconfigp/section.hpp"
+#include "iconfigp/value-parser.hpp"
+
+#include <exception>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+// number of definitions of a key per section
+enum class cardinality {
+  optional,     // ?
+  one,          // 1
+  any,          // *
+  at_least_one, // +
+};
+
+}
+
+ICONFIGP_DEFINE_ENUM_LUT_NAMED(iconfigp::cardinality, "count",
+    "?", optional, "1", one, "*", any, "+", at_least_one)
+
+
+
+namespace iconfigp {
+
+// value type which can be referred to by name in a schema, check throws
+// value_parse_exception if a value cannot be parsed
+struct schema_type {
+  std::string_view name;
+  void           (*check)(const key_value&);
+};
+
+
+
+struct validation_report {
+  // in order of traversal: missing_key_exception, multiple_definitions_exception,
+  // value_parse_exception, unknown_key_exception or unknown_section_exception; all of
+  // them own copies of the keys they report, the tree may change afterwards
+  std::vector<std::exception_ptr> errors;
+  size_t                          defaults{0}; // number of keys added with their default
+
+  [[nodiscard]] bool ok() const { return errors.empty(); }
+};
+
+
+
+// Description of the sections and keys of a document, itself written in the iconfigp
+// format (see doc/format.md). The built-in types (string, bool, integers and floating
+// point numbers) are always available, additional ones can be passed as types.
+class schema {
+  public:
+    explicit schema(const section& description, std::span<const schema_type> types = {});
+
+
+
+    template<value_parser_defined T>
+    [[nodiscard]] static schema_type type() {
+      return schema_type{.name = value_parser<T>::name, .check = &check<T>};
+    }
+
+
+
+    // checks all keys and sections of root in a single traversal and adds missing keys
+    // which have a default value
+    [[nodiscard]] validation_report validate(section& root) const;
+
+
+
+  private:
+    template<typename T>
+    using name_map = std::unordered_map<std::string, T, detail::string_hash, std::equal_to<>>;
+
+    struct key_rule {
+      std::string                name;
+      void                     (*check)(const key_value&);
+      cardinality                count;
+      std::optional<std::string> fallback;
+    };
+
+    struct section_rule {
+      std::string               name;
+      std::vector<key_rule>     keys;
+      name_map<size_t>          key_index;
+      std::vector<section_rule> sections;
+      name_map<size_t>          section_index;
+    };
+
+    section_rule root_;
+
+
+
+    [[nodiscard]] static section_rule compile(
+        std::string                  name,
+        const section&               description,
+        std::span<const schema_type> types
+    );
+
+    static void validate(
+        const section_rule& rule,
+        section&            sec,
+        validation_report&  report,
+        const std::string&  missing_path = {}
+    );
+
+
+
+    // same as parse<T>, but without marking the value as used; the exception owns a copy
+    // of kv since validate may append defaults to the tree before the report is read
+    template<value_parser_defined T>
+    static void check(const key_value& kv) {
+      if (auto result = detail::try_parse<T>(kv, kv.value_.content()); !result) {
+        auto ex = result.error().to_exception();
+        ex.detach();
+        throw ex;
+      }
+    }
+};
+
+}
+
+#endif // ICONFIGP_SCHEMA_HPP_INCLUDED
@@ -6,9 +6,14 @@
 
 #include "iconfigp/exception.hpp"
 #include "iconfigp/group.hpp"
+#include "iconfigp/group-index.hpp"
 #include "iconfigp/opt-ref.hpp"
+#include "iconfigp/profile.hpp"
+#include "iconfigp/trace.hpp"
 
 #include <algorithm>
+#include <array>
+#include <concepts>
 #include <iterator>
 #include <numeric>
 #include <span>
@@ -20,7 +25,16 @@
 namespace iconfigp {
 
 class section {
+  friend class document;
+  friend class lazy_document;
+  template<std::unsigned_integral> friend class basic_frozen_document;
+  friend class overlay;
   friend class parser;
+  friend class schema;
+  friend std::vector<multiple_definitions_exception> audit_duplicates(const section&, bool);
+  friend size_t memory_usage(const section&);
+  friend void detail::collect_accesses(const section&, const std::string&,
+                                       std::vector<access_entry>&);
 
   public:
     [[nodiscard]] size_t offset() const { return offset_; }
@@ -50,7 +64,16 @@ class section {
 
 
 
+    // paths of unresolved @include directives in this section
+    [[nodiscard]] std::span<const located_string> includes() const {
+      return includes_;
+    }
+
+
+
     [[nodiscard]] opt_ref<const section> subsection(std::string_view name) const {
+      [[maybe_unused]] access_timer timer;
+
       used_ = true;
 
       auto it = std::ranges::find_if(sections_,
@@ -58,6 +81,7 @@ class section {
 
       if (it != sections_.end()) {
         it->used_ = true;
+        it->lookups_.hit();
         return *it;
       }
       return {};
@@ -68,12 +92,15 @@ class section {
 
 
     [[nodiscard]] opt_ref<const key_value> unique_key(std::string_view name) const {
+      [[maybe_unused]] access_timer timer;
+
       used_ = true;
+      key_lookups_.hit();
 
       opt_ref<const key_value> output;
 
       for (const auto& grp: groups_) {
-        if (auto kv = grp.unique_key(name)) {
+        if (auto kv = grp.find_unique_key(name)) {
           if (output) {
             throw multiple_definitions_exception{*output, *kv, true};
           }
@@ -81,6 +108,44 @@ class section {
         }
       }
 
+      if (output) {
+        ICONFIGP_TRACE(key__hit, name.data(), name.size(), output->key_offset());
+      } else {
+        ICONFIGP_TRACE(key__miss, name.data(), name.size());
+      }
+
+      return output;
+    }
+
+
+
+    // unique_key for every name in a single pass over all groups
+    template<std::convertible_to<std::string_view>... Names>
+    [[nodiscard]] std::array<opt_ref<const key_value>, sizeof...(Names)> unique_keys(
+        const Names&... names
+    ) const {
+      [[maybe_unused]] access_timer timer;
+
+      used_ = true;
+      key_lookups_.hit();
+
+      std::array<std::string_view, sizeof...(Names)>         keys{names...};
+      std::array<opt_ref<const key_value>, sizeof...(Names)> output;
+
+      for (const auto& grp: groups_) {
+        std::array<opt_ref<const key_value>, sizeof...(Names)> found;
+        grp.find_unique_keys(keys, found);
+
+        for (size_t i = 0; i < found.size(); ++i) {
+          if (found[i]) {
+            if (output[i]) {
+              throw multiple_definitions_exception{*output[i], *found[i], true};
+            }
+            output[i] = found[i];
+          }
+        }
+      }
+
       return output;
     }
 
@@ -97,6 +162,36 @@ class section {
 
 
 
+    // indices of all groups which contain key = value; the index for a key is built on
+    // first use and kept until the section is modified
+    [[nodiscard]] std::span<const size_t> find_groups(
+        std::string_view key,
+        std::string_view value
+    ) const {
+      used_ = true;
+
+      return group_index_.find(key, value, [this](std::string_view name) {
+        group_index::value_map map;
+
+        for (size_t i = 0; i < groups_.size(); ++i) {
+          for (const auto& kv: groups_[i].values_) {
+            if (kv.key() != name) {
+              continue;
+            }
+
+            auto& indices = map[kv.value_.content()];
+            if (indices.empty() || indices.back() != i) {
+              indices.push_back(i);
+            }
+          }
+        }
+
+        return map;
+      });
+    }
+
+
+
     [[nodiscard]] size_t count_keys(std::string_view name) const {
       used_ = true;
 
@@ -110,6 +205,9 @@ class section {
 
     [[nodiscard]] bool used() const { return used_; }
 
+    [[nodiscard]] uint64_t lookup_count()     const { return lookups_.count();     }
+    [[nodiscard]] uint64_t key_lookup_count() const { return key_lookups_.count(); }
+
 
 
     [[nodiscard]] std::vector<const key_value*> unused_keys() const {
@@ -161,7 +259,15 @@ class section {
 
     std::vector<group>   groups_;
 
+    std::vector<located_string> includes_;
+
+    group_index          group_index_;
+
     mutable bool         used_{false};
+    bool                 leading_group_{true}; // groups_.front() is not a row
+
+    [[no_unique_address]] access_counter lookups_;
+    [[no_unique_address]] access_counter key_lookups_;
 
 
 
@@ -182,6 +288,7 @@ class section {
       if (current_section_ < sections_.size()) {
         return sections_[current_section_].current_group();
       }
+      group_index_.clear();
       return groups_.back();
     }
 
@@ -191,8 +298,10 @@ class section {
       if (current_section_ < sections_.size()) {
         sections_[current_section_].new_group(offset);
       } else {
+        group_index_.clear();
         if (groups_.back().empty()) {
           groups_.pop_back();
+          leading_group_ = leading_group_ && !groups_.empty();
         }
         groups_.push_back(group{offset});
       }
@@ -209,6 +318,42 @@ class section {
 
 
 
+    void include(located_string path) {
+      if (current_section_ < sections_.size()) {
+        sections_[current_section_].include(std::move(path));
+      } else {
+        includes_.push_back(std::move(path));
+      }
+    }
+
+
+
+    void merge(const section& other) {
+      current_section_ = sections_.size();
+
+      for (const auto& grp: other.groups_) {
+        if (!grp.empty()) {
+          new_group(grp.offset());
+          groups_.back().values_ = grp.values_;
+        }
+      }
+
+      for (const auto& subsec: other.sections_) {
+        if (auto it = std::ranges::find_if(sections_,
+              [&subsec](const auto& sec) { return sec.name_ == subsec.name_; });
+            it != sections_.end()
+        ) {
+          it->merge(subsec);
+        } else {
+          sections_.push_back(subsec);
+        }
+      }
+
+      current_section_ = sections_.size();
+    }
+
+
+
 
 
     void select_section(std::span<std::string> path, size_t offset) {
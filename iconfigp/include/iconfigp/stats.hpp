@@ -0,0 +1,56 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_STATS_HPP_INCLUDED
+#define ICONFIGP_STATS_HPP_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+struct parse_stats {
+  size_t                   bytes_scanned{0};
+
+  size_t                   sections     {0};
+  size_t                   groups       {0};
+  size_t                   keys         {0};
+
+  size_t                   escapes      {0};
+  size_t                   quotes       {0};
+
+  size_t                   max_depth    {0};
+
+  std::chrono::nanoseconds reader_time  {0};
+  std::chrono::nanoseconds tree_time    {0};
+
+  size_t                   tree_bytes   {0};
+};
+
+
+
+class section;
+
+// heap memory (in bytes) owned by the section and all of its descendants, strings
+// interned in a string_pool are owned by the pool
+[[nodiscard]] size_t memory_usage(const section&);
+
+
+
+namespace detail {
+  // 0 for strings stored inline (small string optimization)
+  [[nodiscard]] size_t heap_size(const std::string&);
+
+  template<typename T>
+  [[nodiscard]] size_t heap_size(const std::vector<T>& vec) {
+    return vec.capacity() * sizeof(T);
+  }
+}
+
+}
+
+#endif // ICONFIGP_STATS_HPP_INCLUDED
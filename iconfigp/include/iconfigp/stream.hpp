@@ -0,0 +1,35 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_STREAM_HPP_INCLUDED
+#define ICONFIGP_STREAM_HPP_INCLUDED
+
+#include "iconfigp/generator.hpp"
+#include "iconfigp/key-value.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+struct streamed_group {
+  size_t                 offset;
+  std::vector<key_value> entries;
+};
+
+// Yields the non-empty groups of the section at path (empty for the root section) while
+// reading input, only the current group is held in memory. Groups are yielded in the
+// same order as section::groups() would list them; @include directives are not
+// resolved. input has to outlive the generator.
+[[nodiscard]] generator<streamed_group> stream_groups(
+    std::string_view         input,
+    std::vector<std::string> path,
+    size_t                   base_offset = 0
+);
+
+}
+
+#endif // ICONFIGP_STREAM_HPP_INCLUDED
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_STRING_POOL_HPP_INCLUDED
+#define ICONFIGP_STRING_POOL_HPP_INCLUDED
+
+#include "iconfigp/key.hpp"
+#include "iconfigp/located-string.hpp"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+
+
+namespace iconfigp {
+
+// Thread-safe set of strings which can be shared by any number of documents. Every
+// distinct string is stored once, interned located_strings refer to it. The pool must
+// outlive all documents parsed with it.
+class string_pool {
+  public:
+    [[nodiscard]] const std::string& intern(std::string_view);
+
+    [[nodiscard]] located_string intern(located_string&& str) {
+      return located_string{&intern(str.content()), str.offset(), str.size()};
+    }
+
+
+
+    [[nodiscard]] size_t size() const;
+
+    // heap memory in bytes used by the pooled strings
+    [[nodiscard]] size_t memory_usage() const;
+
+
+
+  private:
+    mutable std::mutex                                                    mutex_;
+    std::unordered_set<std::string, detail::string_hash, std::equal_to<>> strings_;
+};
+
+}
+
+#endif // ICONFIGP_STRING_POOL_HPP_INCLUDED
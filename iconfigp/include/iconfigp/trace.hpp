@@ -0,0 +1,33 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_TRACE_HPP_INCLUDED
+#define ICONFIGP_TRACE_HPP_INCLUDED
+
+// Static tracepoints (USDT) for the provider "iconfigp". They are only compiled in if
+// the library is configured with -Dtracing=true, otherwise they vanish entirely.
+//
+// Available probes:
+//   parse__start         (input, size)
+//   parse__end           (input, size)
+//   section__header      (offset, depth)
+//   key__hit             (key, key size, offset)
+//   key__miss            (key, key size)
+//   value__parse__success(target, target size, offset)
+//   value__parse__failure(target, target size, offset)
+
+#if defined(ICONFIGP_TRACING)
+
+#include <sys/sdt.h>
+
+//NOLINTNEXTLINE(*-macro-usage)
+#define ICONFIGP_TRACE(probe, ...) STAP_PROBEV(iconfigp, probe __VA_OPT__(,) __VA_ARGS__)
+
+#else
+
+//NOLINTNEXTLINE(*-macro-usage)
+#define ICONFIGP_TRACE(probe, ...) do {} while (false)
+
+#endif
+
+#endif // ICONFIGP_TRACE_HPP_INCLUDED
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#ifndef ICONFIGP_VALIDATE_HPP_INCLUDED
+#define ICONFIGP_VALIDATE_HPP_INCLUDED
+
+#include "iconfigp/key-path.hpp"
+#include "iconfigp/schema.hpp"
+#include "iconfigp/section.hpp"
+#include "iconfigp/value-parser.hpp"
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+
+
+namespace iconfigp {
+
+// typed key which validate_all expects in a document, see expect<T>
+struct key_expectation {
+  key_path                     path;
+  bool                         required;
+  std::optional<value_error> (*check)(const key_value&);
+};
+
+
+
+template<value_parser_defined T>
+[[nodiscard]] key_expectation expect(std::string_view path, bool required = true) {
+  return key_expectation{
+    .path     = key_path{path},
+    .required = required,
+    .check    = [](const key_value& kv) -> std::optional<value_error> {
+      if (auto result = try_parse<T>(kv); !result) {
+        return std::move(result).error();
+      }
+      return {};
+    }
+  };
+}
+
+
+
+// Looks up and parses all expected keys of root and collects every failure instead of
+// stopping at the first one: missing_key_exception for missing required keys,
+// multiple_definitions_exception for keys defined more than once per group or section
+// and value_parse_exception for values which cannot be parsed. The errors are in the
+// order of the expectations, found keys are marked as used.
+// If parallel is set, large lists of expectations are checked on separate threads.
+[[nodiscard]] validation_report validate_all(
+    const section&                   root,
+    std::span<const key_expectation> expectations,
+    bool                             parallel = false
+);
+
+
+
+// Finds all keys of root and its subsections which are defined more than once per group
+// in a single pass, without marking anything as used. With per_section set, keys which
+// are defined in more than one group of a section are reported as well, although
+// repeating keys across groups is fine for sections which are read group by group.
+[[nodiscard]] std::vector<multiple_definitions_exception> audit_duplicates(
+    const section& root,
+    bool           per_section = false
+);
+
+}
+
+#endif // ICONFIGP_VALIDATE_HPP_INCLUDED
@@ -5,18 +5,24 @@
 #define ICONFIGP_VALUE_PARSER_HPP_INCLUDED
 
 #include "iconfigp/exception.hpp"
+#include "iconfigp/expected.hpp"
 #include "iconfigp/format.hpp"
 #include "iconfigp/key-value.hpp"
 #include "iconfigp/opt-ref.hpp"
+#include "iconfigp/trace.hpp"
 
 #include <algorithm>
 #include <array>
 #include <charconv>
+#include <concepts>
 #include <cstdint>
 #include <limits>
 #include <optional>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
 
 
 
@@ -286,24 +292,139 @@ concept value_parser_defined = requires () { value_parser<T>::name; };
 
 
 
-template<value_parser_defined T>
-[[nodiscard]] T parse(const key_value& value) {
-  try {
-    if (auto result = value_parser<T>::parse(value.value())) {
-      return *result;
+// a failed part of a value, offset and size are relative to the start of the value
+struct range_error {
+  std::string message;
+  size_t      offset;
+  size_t      size{0};
+
+  [[nodiscard]] value_parse_exception::range_exception to_exception() const {
+    return value_parse_exception::range_exception{message, offset, size};
+  }
+};
+
+
+
+// value_parsers may define
+//   static expected<T, range_error> try_parse(std::string_view);
+// to report the failed range without throwing a range_exception
+template<typename T>
+concept value_parser_reports_range = requires (std::string_view input) {
+  { value_parser<T>::try_parse(input) } -> std::same_as<expected<T, range_error>>;
+};
+
+
+
+// error channel of try_parse, refers to value which has to outlive it
+struct value_error {
+  const key_value*           value;
+  std::string_view           target;
+  std::string_view           format;
+  std::optional<range_error> range;
+
+  // the exception refers to value like the value_error itself, see
+  // value_parse_exception::detach
+  [[nodiscard]] value_parse_exception to_exception() const {
+    std::optional<value_parse_exception::range_exception> range_ex;
+    if (range) {
+      range_ex = range->to_exception();
+    }
+    return value_parse_exception::borrowing(*value, target, format, std::move(range_ex));
+  }
+};
+
+
+
+namespace detail {
+  // value_parser<T>::format() is only built once, value_errors refer to it
+  template<value_parser_defined T>
+  [[nodiscard]] std::string_view cached_format() {
+    static const std::string format{value_parser<T>::format()};
+    return format;
+  }
+
+
+
+  // content is the value of kv, passed separately to decide whether it is marked as used
+  template<value_parser_defined T>
+  [[nodiscard]] expected<T, value_error> try_parse(
+      const key_value& kv,
+      std::string_view content
+  ) {
+    [[maybe_unused]] std::string_view target{value_parser<T>::name};
+
+    auto failure = [&](std::optional<range_error> range = {}) {
+      ICONFIGP_TRACE(value__parse__failure,
+          target.data(), target.size(), kv.value_offset());
+      return unexpected{value_error{&kv, value_parser<T>::name,
+        detail::cached_format<T>(), std::move(range)}};
+    };
+
+    std::optional<T> result;
+
+    if constexpr (value_parser_reports_range<T>) {
+      auto output = value_parser<T>::try_parse(content);
+      if (!output) {
+        return failure(std::move(output).error());
+      }
+      result.emplace(std::move(*output));
+
+    } else {
+      // value_parsers without try_parse may still throw, which only costs on failure
+      try {
+        result = value_parser<T>::parse(content);
+      } catch (const value_parse_exception::range_exception& rex) {
+        return failure(range_error{std::string{rex.message()}, rex.offset(), rex.size()});
+      } catch (...) {
+        return failure();
+      }
+
+      if (!result) {
+        return failure();
+      }
     }
 
-  } catch (const value_parse_exception::range_exception& rex) {
-    throw value_parse_exception{value, std::string{value_parser<T>::name},
-      std::string{value_parser<T>::format()}, rex};
+    ICONFIGP_TRACE(value__parse__success, target.data(), target.size(), kv.value_offset());
+    return std::move(*result);
+  }
+}
+
+
+
+// same as parse<T>, but reports failures as value_error instead of throwing; the error
+// refers to value, which has to outlive it
+template<value_parser_defined T>
+[[nodiscard]] expected<T, value_error> try_parse(const key_value& value) {
+  return detail::try_parse<T>(value, value.value());
+}
+
+
 
-  } catch (...) {
-    throw value_parse_exception{value, std::string{value_parser<T>::name},
-      std::string{value_parser<T>::format()}};
+template<value_parser_defined T>
+[[nodiscard]] expected<std::optional<T>, value_error> try_parse(
+    opt_ref<const key_value> value
+) {
+  if (!value) {
+    return std::optional<T>{};
+  }
+
+  auto result = try_parse<T>(*value);
+  if (!result) {
+    return unexpected{std::move(result).error()};
   }
+  return std::optional<T>{std::move(*result)};
+}
 
-  throw value_parse_exception{value, std::string{value_parser<T>::name},
-    std::string{value_parser<T>::format()}};
+
+
+// the exception refers to value, which has to outlive it
+template<value_parser_defined T>
+[[nodiscard]] T parse(const key_value& value) {
+  auto result = try_parse<T>(value);
+  if (!result) {
+    throw result.error().to_exception();
+  }
+  return std::move(*result);
 }
 
 
@@ -316,6 +437,22 @@ template<value_parser_defined T>
   return {};
 }
 
+
+
+// typed unique_keys of a section or group, e.g. parse_keys<int, bool>(sec, "a", "b")
+template<value_parser_defined... Ts, typename Container, typename... Names>
+  requires (sizeof...(Ts) == sizeof...(Names))
+[[nodiscard]] std::tuple<std::optional<Ts>...> parse_keys(
+    const Container& container,
+    const Names&...  names
+) {
+  auto values = container.unique_keys(names...);
+
+  return [&values]<size_t... Index>(std::index_sequence<Index...>) {
+    return std::tuple<std::optional<Ts>...>{parse<Ts>(values[Index])...};
+  }(std::index_sequence_for<Ts...>{});
+}
+
 }
 
 
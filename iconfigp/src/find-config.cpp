@@ -1,5 +1,8 @@
 #include "iconfigp/find-config.hpp"
 
+#include <algorithm>
+#include <string>
+
 #include <unistd.h>
 
 
@@ -50,6 +53,80 @@ namespace {
     }
     return {};
   }
+
+
+
+  [[nodiscard]] std::vector<std::filesystem::path> config_dirs() {
+    std::string_view dirs{"/etc/xdg"};
+
+    //NOLINTNEXTLINE(*mt-unsafe)
+    if (const char* value = getenv("XDG_CONFIG_DIRS"); value != nullptr && *value != 0) {
+      dirs = value;
+    }
+
+    std::vector<std::filesystem::path> output;
+
+    while (!dirs.empty()) {
+      auto dir = dirs.substr(0, dirs.find(':'));
+      dirs.remove_prefix(std::min(dir.size() + 1, dirs.size()));
+
+      // relative paths are invalid according to the XDG base directory specification
+      if (std::filesystem::path path{dir}; path.is_absolute()) {
+        output.emplace_back(std::move(path));
+      }
+    }
+
+    return output;
+  }
+
+
+
+  [[nodiscard]] bool is_file(const std::filesystem::path& path) {
+    return std::filesystem::exists(path) && !std::filesystem::is_directory(path);
+  }
+
+
+
+  [[nodiscard]] char to_config_name(char c) {
+    return c == '_' ? '-' : to_lower(c);
+  }
+
+
+
+  [[nodiscard]] std::optional<iconfigp::environment_override> parse_override(
+      std::string_view variable,
+      std::string_view prefix
+  ) {
+    auto split = variable.find('=');
+    if (split == std::string_view::npos || !variable.substr(0, split).starts_with(prefix)) {
+      return {};
+    }
+
+    iconfigp::environment_override output{
+      .variable = std::string{variable.substr(0, split)},
+      .section  = {},
+      .key      = {},
+      .value    = std::string{variable.substr(split + 1)}
+    };
+
+    static constexpr std::string_view separator{"__"};
+
+    auto path = variable.substr(prefix.size(), split - prefix.size());
+    while (true) {
+      auto part = path.substr(0, path.find(separator));
+      if (part.empty()) {
+        return {};
+      }
+
+      if (part.size() == path.size()) {
+        output.key = join(part, "", to_config_name);
+        return output;
+      }
+
+      output.section.emplace_back(join(part, "", to_config_name));
+      path.remove_prefix(part.size() + separator.size());
+    }
+  }
 }
 
 
@@ -61,17 +138,55 @@ std::optional<std::filesystem::path> iconfigp::find_config_file(std::string_view
 
   if (auto xdg_config_home = envpath("XDG_CONFIG_HOME")) {
     auto candidate = *xdg_config_home / join(name, "/config.ini", to_lower);
-    if (std::filesystem::exists(candidate) && !std::filesystem::is_directory(candidate)) {
+    if (is_file(candidate)) {
       return candidate;
     }
   }
 
   if (auto home = envpath("HOME")) {
     auto candidate = *home / ".config" / join(name, "/config.ini", to_lower);
-    if (std::filesystem::exists(candidate) && !std::filesystem::is_directory(candidate)) {
+    if (is_file(candidate)) {
       return candidate;
     }
   }
 
   return {};
 }
+
+
+
+std::vector<iconfigp::environment_override> iconfigp::find_environment_overrides(
+    std::string_view name
+) {
+  auto prefix = join(name, "__", to_upper);
+
+  std::vector<environment_override> output;
+
+  //NOLINTNEXTLINE(*-pointer-arithmetic)
+  for (char** variable = environ; variable != nullptr && *variable != nullptr; ++variable) {
+    if (auto entry = parse_override(*variable, prefix)) {
+      output.emplace_back(std::move(*entry));
+    }
+  }
+
+  return output;
+}
+
+
+
+std::vector<std::filesystem::path> iconfigp::find_config_files(std::string_view name) {
+  std::vector<std::filesystem::path> output;
+
+  auto dirs = config_dirs();
+  for (auto it = dirs.rbegin(); it != dirs.rend(); ++it) {
+    if (auto candidate = *it / join(name, "/config.ini", to_lower); is_file(candidate)) {
+      output.emplace_back(std::move(candidate));
+    }
+  }
+
+  if (auto user = find_config_file(name)) {
+    output.emplace_back(std::move(*user));
+  }
+
+  return output;
+}
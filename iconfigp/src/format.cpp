@@ -4,11 +4,16 @@
 #include "iconfigp/format.hpp"
 
 #include "iconfigp/exception.hpp"
+#include "iconfigp/schema.hpp"
 #include "iconfigp/section.hpp"
 #include "iconfigp/serialize.hpp"
 
+#include <algorithm>
+#include <array>
+#include <exception>
 #include <optional>
 #include <stdexcept>
+#include <vector>
 
 #include <cstddef>
 
@@ -191,6 +196,39 @@ namespace {
 
 
 
+namespace {
+  [[nodiscard]] std::string highlight_line(
+      text_line     line,
+      size_t        length,
+      message_color color,
+      bool          line_number,
+      size_t        max_width
+  ) {
+    auto prefix      = line_number ? format("  {} | ", line.row + 1) : "  ";
+    auto prefix_size = prefix.size();
+
+    max_width = (prefix_size >= max_width + min_size) ?
+                   min_size : max_width - prefix_size;
+
+    length = std::min(length, line.content.size());
+
+    auto [print, col] = center_offset(line.content, line.column, max_width);
+
+    if (length + col > max_width) {
+      length = 0;
+    }
+
+    return iconfigp::format("{}{}\n{}{}\n",
+        dim(std::move(prefix), is_color(color)),
+        emphasize_range(print, col, length, is_color(color)),
+        std::string(prefix_size + col, ' '),
+        colorize(std::string(std::max<size_t>(length, 1), '^'), color)
+    );
+  }
+}
+
+
+
 std::string iconfigp::highlight_text_segment(
     std::string_view content,
     size_t           offset,
@@ -203,37 +241,141 @@ std::string iconfigp::highlight_text_segment(
     return fallback_range(offset, length);
   }
 
-  auto line = text_line_from_offset(content, std::min(offset, content.size() - 1));
+  return highlight_line(text_line_from_offset(content, std::min(offset, content.size() - 1)),
+      length, color, line_number, max_width);
+}
+
 
-  auto prefix      = line_number ? format("  {} | ", line.row + 1) : "  ";
-  auto prefix_size = prefix.size();
 
-  max_width = (prefix_size >= max_width + min_size) ?
-                 min_size : max_width - prefix_size;
 
-  length = std::min(length, line.content.size());
 
-  auto [print, col] = center_offset(line.content, line.column, max_width);
 
-  if (length + col > max_width) {
-    length = 0;
-  }
 
-  return iconfigp::format("{}{}\n{}{}\n",
-      dim(std::move(prefix), is_color(color)),
-      emphasize_range(print, col, length, is_color(color)),
-      std::string(prefix_size + col, ' '),
-      colorize(std::string(std::max<size_t>(length, 1), '^'), color)
-  );
-}
+namespace {
+  // start offsets of all lines of a text, same lookup as text_line_from_offset without
+  // scanning the text up to the offset
+  class line_index {
+    public:
+      explicit line_index(std::string_view text) :
+        text_{text}
+      {
+        starts_.push_back(0);
+        for (auto pos = text.find('\n'); pos != std::string_view::npos;
+             pos = text.find('\n', pos + 1)) {
+          starts_.push_back(pos + 1);
+        }
+      }
 
 
 
+      [[nodiscard]] text_line line(size_t offset) const {
+        auto row = static_cast<size_t>(std::ranges::upper_bound(starts_, offset)
+                                       - starts_.begin()) - 1;
+
+        auto begin = starts_[row];
+        auto end   = row + 1 < starts_.size() ? starts_[row + 1] - 1 : text_.size();
+
+        return {
+          .content = text_.substr(begin, end - begin),
+          .row     = row,
+          .column  = (offset == end && end < text_.size()) ?
+                       offset - begin - 1 : offset - begin
+        };
+      }
+
+
+
+    private:
+      std::string_view    text_;
+      std::vector<size_t> starts_;
+  };
+
+
+
+  class source_lookup {
+    public:
+      // with indexed set, the lines of all sources are indexed up front, which pays off
+      // if more than one message is highlighted
+      explicit source_lookup(std::span<const source_file> sources, bool indexed = false) :
+        sources_{sources}
+      {
+        if (indexed) {
+          for (const auto& file: sources_) {
+            indices_.emplace_back(file.content);
+          }
+        }
+      }
+
+
+
+      [[nodiscard]] bool empty() const {
+        return std::ranges::all_of(sources_,
+            [](const auto& file) { return file.content.empty(); });
+      }
+
+
+
+      [[nodiscard]] std::string highlight(
+          size_t        offset,
+          size_t        length,
+          message_color color,
+          size_t        max_width
+      ) const {
+        const auto* file = find(offset);
+        if (file == nullptr) {
+          return highlight_text_segment("", offset, length, color, true, max_width);
+        }
+
+        auto local   = offset - file->offset;
+        auto segment = highlight(*file, local, length, color, max_width);
+
+        if (file->name.empty()) {
+          return segment;
+        }
+
+        return iconfigp::format("{}\n{}",
+            dim(iconfigp::format("  {}:", file->name), is_color(color)), segment);
+      }
+
+
+
+    private:
+      std::span<const source_file> sources_;
+      std::vector<line_index>      indices_;
+
+
+
+      [[nodiscard]] std::string highlight(
+          const source_file& file,
+          size_t             offset,
+          size_t             length,
+          message_color      color,
+          size_t             max_width
+      ) const {
+        if (indices_.empty() || file.content.empty() || offset + length > file.content.size()) {
+          return highlight_text_segment(file.content, offset, length, color, true, max_width);
+        }
+
+        const auto& index = indices_[&file - sources_.data()];
+        return highlight_line(index.line(std::min(offset, file.content.size() - 1)),
+            length, color, true, max_width);
+      }
+
+
+
+      [[nodiscard]] const source_file* find(size_t offset) const {
+        auto it = std::ranges::find_if(sources_, [offset](const auto& file) {
+            return file.offset <= offset && offset - file.offset <= file.content.size();
+        });
+
+        return it != sources_.end() ? &*it : nullptr;
+      }
+  };
+
 
 
 
 
-namespace {
   [[nodiscard]] std::string format_range(
     const value_parse_exception::range_exception& ex,
     std::string_view                              source,
@@ -252,16 +394,33 @@ namespace {
 
 
 
+  [[nodiscard]] std::string format_range(
+    const value_parse_exception::range_exception& ex,
+    const source_lookup&                          source,
+    bool                                          colored,
+    size_t                                        max_width
+  ) {
+    return iconfigp::format("{}:\n{}",
+        ex.message(),
+        source.highlight(ex.offset(), ex.size(),
+          select_color(colored, message_color::error), max_width)
+    );
+  }
+
+
+
+
+
   [[nodiscard]] std::string format_missing_key(
     const missing_key_exception& ex,
-    std::string_view             source,
+    const source_lookup&         source,
     bool                         colored,
     size_t                       max_width
   ) {
     return iconfigp::format("The required key {} is missing in this group:\n{}",
         emphasize(iconfigp::serialize(ex.key()), colored),
-        highlight_text_segment(source, ex.offset(), 0,
-          select_color(colored, message_color::error), true, max_width)
+        source.highlight(ex.offset(), 0,
+          select_color(colored, message_color::error), max_width)
     );
   }
 
@@ -271,7 +430,7 @@ namespace {
 
   [[nodiscard]] std::string format_value_parse(
     const value_parse_exception& ex,
-    std::string_view             source,
+    const source_lookup&         source,
     bool                         colored,
     size_t                       max_width
   ) {
@@ -282,8 +441,8 @@ namespace {
 
         emphasize(iconfigp::serialize(ex.target()), colored),
 
-        highlight_text_segment(source, ex.value().value_offset(), ex.value().value_size(),
-          select_color(colored, message_color::error), true, max_width),
+        source.highlight(ex.value().value_offset(), ex.value().value_size(),
+          select_color(colored, message_color::error), max_width),
 
         ex.range_ex()
           ? (format_range(*ex.range_ex(), ex.value().value(), colored, max_width, false))
@@ -300,7 +459,7 @@ namespace {
 
   [[nodiscard]] std::string format_multiple_definitions(
     const multiple_definitions_exception& ex,
-    std::string_view                      source,
+    const source_lookup&                  source,
     bool                                  colored,
     size_t                                max_width
   ) {
@@ -311,13 +470,11 @@ namespace {
 
         ex.per_section() ? "section" : "group",
 
-        highlight_text_segment(source, ex.definition2().key_offset(),
-          ex.definition2().key_size(),
-          select_color(colored, message_color::error), true, max_width),
+        source.highlight(ex.definition2().key_offset(), ex.definition2().key_size(),
+          select_color(colored, message_color::error), max_width),
 
-        highlight_text_segment(source, ex.definition1().key_offset(),
-          ex.definition1().key_size(),
-          select_color(colored, message_color::warning), true, max_width),
+        source.highlight(ex.definition1().key_offset(), ex.definition1().key_size(),
+          select_color(colored, message_color::warning), max_width),
 
         ex.per_section() ? "" : "Preceed the key with - to start a new group.\n"
     );
@@ -327,6 +484,40 @@ namespace {
 
 
 
+  [[nodiscard]] std::string format_unknown_key(
+    const unknown_key_exception& ex,
+    const source_lookup&         source,
+    bool                         colored,
+    size_t                       max_width
+  ) {
+    return iconfigp::format("The key {} is not part of the schema:\n{}",
+        emphasize(iconfigp::serialize(ex.definition().key()), colored),
+        source.highlight(ex.definition().key_offset(), ex.definition().key_size(),
+          select_color(colored, message_color::error), max_width)
+    );
+  }
+
+
+
+
+
+  [[nodiscard]] std::string format_unknown_section(
+    const unknown_section_exception& ex,
+    const source_lookup&             source,
+    bool                             colored,
+    size_t                           max_width
+  ) {
+    return iconfigp::format("The section {} is not part of the schema:\n{}",
+        emphasize(iconfigp::serialize(ex.name()), colored),
+        source.highlight(ex.offset(), 0,
+          select_color(colored, message_color::error), max_width)
+    );
+  }
+
+
+
+
+
   [[nodiscard]] std::string_view error_type_to_string(iconfigp::syntax_error_type type) {
     using enum iconfigp::syntax_error_type;
     switch (type) {
@@ -340,6 +531,8 @@ namespace {
 
       case empty_key:
         return "Empty string";
+      case empty_include:
+        return "Empty include path";
       case unexpected_semicolon:
         return "Unexpected semicolon";
       case missing_section_end:
@@ -364,6 +557,7 @@ namespace {
         return 1;
       case iconfigp::syntax_error_type::missing_value:
       case iconfigp::syntax_error_type::empty_key:
+      case iconfigp::syntax_error_type::empty_include:
       default:
         return 0;
     }
@@ -385,6 +579,8 @@ namespace {
         return "Keys must not be empty.\n";
       case missing_value:
         return "Values are introduced using '='.\n";
+      case empty_include:
+        return "@include expects the path of the file to include.\n";
       default:
         return {};
     }
@@ -398,6 +594,7 @@ namespace {
       case key:      return "a key";
       case value:    return "a value";
       case section:  return "a section header";
+      case include:  return "an include directive";
       case toplevel: return "a toplevel element";
     }
     return "something";
@@ -407,7 +604,7 @@ namespace {
 
   [[nodiscard]] std::string format_syntax(
     const iconfigp::syntax_exception& ex,
-    std::string_view                  source,
+    const source_lookup&              source,
     bool                              colored,
     size_t                            max_width
   ) {
@@ -416,12 +613,79 @@ namespace {
 
         task_type_to_string(ex.task()),
 
-        highlight_text_segment(source, ex.offset(), error_type_character_count(ex.type()),
-          select_color(colored, message_color::error), true, max_width),
+        source.highlight(ex.offset(), error_type_character_count(ex.type()),
+          select_color(colored, message_color::error), max_width),
 
         error_type_hint(ex.type()).value_or("")
     );
   }
+
+
+
+
+
+  [[nodiscard]] std::string format_include(
+    const iconfigp::include_exception& ex,
+    const source_lookup&               source,
+    bool                               colored,
+    size_t                             max_width
+  ) {
+    return iconfigp::format("{} {}:\n{}",
+        ex.type() == include_error_type::cycle ?
+          "Cyclic include of" : "Unable to read the included file",
+
+        emphasize(iconfigp::serialize(ex.path()), colored),
+
+        source.highlight(ex.offset(), ex.size(),
+          select_color(colored, message_color::error), max_width)
+    );
+  }
+
+
+
+
+
+  [[nodiscard]] std::string format_message(
+    const exception&     ex,
+    const source_lookup& source,
+    bool                 colored,
+    size_t               max_width
+  ) {
+    if (const auto* missing = dynamic_cast<const missing_key_exception*>(&ex)) {
+      return format_missing_key(*missing, source, colored, max_width);
+    }
+
+    if (const auto* parse = dynamic_cast<const value_parse_exception*>(&ex)) {
+      return format_value_parse(*parse, source, colored, max_width);
+    }
+
+    if (const auto* multi = dynamic_cast<const multiple_definitions_exception*>(&ex)) {
+      return format_multiple_definitions(*multi, source, colored, max_width);
+    }
+
+    if (const auto* unknown = dynamic_cast<const unknown_key_exception*>(&ex)) {
+      return format_unknown_key(*unknown, source, colored, max_width);
+    }
+
+    if (const auto* unknown = dynamic_cast<const unknown_section_exception*>(&ex)) {
+      return format_unknown_section(*unknown, source, colored, max_width);
+    }
+
+    if (const auto* syntax = dynamic_cast<const syntax_exception*>(&ex)) {
+      return format_syntax(*syntax, source, colored, max_width);
+    }
+
+    if (const auto* include = dynamic_cast<const include_exception*>(&ex)) {
+      return format_include(*include, source, colored, max_width);
+    }
+
+    if (const auto* range =
+        dynamic_cast<const value_parse_exception::range_exception*>(&ex)) {
+      return format_range(*range, source, colored, max_width);
+    }
+
+    return ex.what();
+  }
 }
 
 
@@ -434,28 +698,72 @@ std::string iconfigp::format_exception(
   bool             colored,
   size_t           max_width
 ) {
-  if (const auto* missing = dynamic_cast<const missing_key_exception*>(&ex)) {
-    return format_missing_key(*missing, source, colored, max_width);
-  }
+  std::array<source_file, 1> sources{source_file{
+    .name    = {},
+    .content = source,
+    .offset  = 0
+  }};
 
-  if (const auto* parse = dynamic_cast<const value_parse_exception*>(&ex)) {
-    return format_value_parse(*parse, source, colored, max_width);
-  }
+  return format_exception(ex, sources, colored, max_width);
+}
 
-  if (const auto* multi = dynamic_cast<const multiple_definitions_exception*>(&ex)) {
-    return format_multiple_definitions(*multi, source, colored, max_width);
-  }
 
-  if (const auto* syntax = dynamic_cast<const syntax_exception*>(&ex)) {
-    return format_syntax(*syntax, source, colored, max_width);
-  }
 
-  if (const auto* range =
-      dynamic_cast<const value_parse_exception::range_exception*>(&ex)) {
-    return format_range(*range, source, colored, max_width);
+std::string iconfigp::format_exception(
+  const exception&             ex,
+  std::span<const source_file> sources,
+  bool                         colored,
+  size_t                       max_width
+) {
+  return format_message(ex, source_lookup{sources}, colored, max_width);
+}
+
+
+
+
+
+std::string iconfigp::format_report(
+  const validation_report& report,
+  std::string_view         source,
+  bool                     colored,
+  size_t                   max_width
+) {
+  std::array<source_file, 1> sources{source_file{
+    .name    = {},
+    .content = source,
+    .offset  = 0
+  }};
+
+  return format_report(report, sources, colored, max_width);
+}
+
+
+
+std::string iconfigp::format_report(
+  const validation_report&     report,
+  std::span<const source_file> sources,
+  bool                         colored,
+  size_t                       max_width
+) {
+  source_lookup source{sources, true};
+
+  std::string output;
+
+  for (const auto& error: report.errors) {
+    if (!output.empty()) {
+      output += '\n';
+    }
+
+    try {
+      std::rethrow_exception(error);
+    } catch (const exception& ex) {
+      output += format_message(ex, source, colored, max_width);
+    } catch (const std::exception& ex) {
+      output += iconfigp::format("{}\n", ex.what());
+    }
   }
 
-  return ex.what();
+  return output;
 }
 
 
@@ -482,6 +790,25 @@ std::optional<std::string> iconfigp::format_unused_message(
     bool             colored,
     size_t           max_width
 ) {
+  std::array<source_file, 1> sources{source_file{
+    .name    = {},
+    .content = source,
+    .offset  = 0
+  }};
+
+  return format_unused_message(sec, sources, colored, max_width);
+}
+
+
+
+std::optional<std::string> iconfigp::format_unused_message(
+    const section&               sec,
+    std::span<const source_file> sources,
+    bool                         colored,
+    size_t                       max_width
+) {
+  source_lookup source{sources};
+
   std::string output;
 
   auto unused_sections = sec.unused_sections();
@@ -494,8 +821,8 @@ std::optional<std::string> iconfigp::format_unused_message(
       if (source.empty()) {
         output += iconfigp::format("  {}\n", un_sec->name());
       } else {
-        output += highlight_text_segment(source, un_sec->offset(), 0,
-            select_color(colored, message_color::warning), true, max_width);
+        output += source.highlight(un_sec->offset(), 0,
+            select_color(colored, message_color::warning), max_width);
       }
     }
   }
@@ -512,8 +839,8 @@ std::optional<std::string> iconfigp::format_unused_message(
       if (source.empty()) {
         output += iconfigp::format("  {}\n", un_key->key());
       } else {
-        output += highlight_text_segment(source, un_key->key_offset(), un_key->key_size(),
-            select_color(colored, message_color::warning), true, max_width);
+        output += source.highlight(un_key->key_offset(), un_key->key_size(),
+            select_color(colored, message_color::warning), max_width);
       }
     }
   }
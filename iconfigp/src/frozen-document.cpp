@@ -0,0 +1,209 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/frozen-document.hpp"
+
+#include "iconfigp/stats.hpp"
+
+#include <bit>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+
+
+namespace {
+  using iconfigp::detail::heap_size;
+}
+
+
+
+//NOLINTBEGIN(*-global-variables)
+namespace { namespace global_state {
+  std::atomic<uint32_t> generation{0};
+}}
+//NOLINTEND(*-global-variables)
+
+
+
+uint32_t iconfigp::detail::next_generation() {
+  uint32_t gen = global_state::generation.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (gen == 0) {
+    gen = global_state::generation.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  return gen;
+}
+
+
+
+template<std::unsigned_integral Offset>
+iconfigp::basic_frozen_document<Offset>::basic_frozen_document(const section& root) :
+  generation_{detail::next_generation()}
+{
+  add(root, 0);
+
+  sections_.groups.push_back(narrow(groups_.offset.size()));
+  groups_.keys.push_back(narrow(keys_.key.size()));
+
+  sections_.used = flag_set{sections_.offset.size()};
+  keys_.used     = flag_set{keys_.key.size()};
+
+  build_index();
+}
+
+
+
+template<std::unsigned_integral Offset>
+void iconfigp::basic_frozen_document<Offset>::build_index() {
+  for (size_t i = 0; i < section_count(); ++i) {
+    size_t first_key = groups_.keys[sections_.groups[i]];
+    size_t last_key  = groups_.keys[sections_.groups[i + 1]];
+
+    size_t first = slots_.size();
+    sections_.slots.push_back(narrow(first));
+
+    if (first_key == last_key) {
+      continue;
+    }
+
+    // at most half full to keep probe sequences short
+    size_t size = std::bit_ceil(2 * (last_key - first_key));
+    slots_.resize(first + size, 0);
+
+    for (size_t k = first_key; k < last_key; ++k) {
+      size_t probe = keys_.hash[k] & (size - 1);
+      while (slots_[first + probe] != 0) {
+        probe = (probe + 1) & (size - 1);
+      }
+      slots_[first + probe] = narrow(k + 1);
+    }
+  }
+
+  sections_.slots.push_back(narrow(slots_.size()));
+}
+
+
+
+template<std::unsigned_integral Offset>
+Offset iconfigp::basic_frozen_document<Offset>::narrow(size_t value) {
+  if (value > std::numeric_limits<Offset>::max()) {
+    throw std::length_error{"document exceeds the offset range of the frozen layout"};
+  }
+  return static_cast<Offset>(value);
+}
+
+
+
+template<std::unsigned_integral Offset>
+typename iconfigp::basic_frozen_document<Offset>::string_ref
+iconfigp::basic_frozen_document<Offset>::store(std::string_view str) {
+  // every string has to end within the offset range as well
+  std::ignore = narrow(arena_.size() + str.size());
+
+  string_ref ref{.begin = narrow(arena_.size()), .size = narrow(str.size())};
+  arena_ += str;
+  return ref;
+}
+
+
+
+template<std::unsigned_integral Offset>
+void iconfigp::basic_frozen_document<Offset>::add(const section& sec, size_t parent) {
+  size_t index = sections_.offset.size();
+
+  sections_.name.push_back(store(sec.name_));
+  sections_.offset.push_back(narrow(sec.offset_));
+  sections_.parent.push_back(narrow(parent));
+  sections_.end.push_back(0);
+  sections_.groups.push_back(narrow(groups_.offset.size()));
+
+  for (const auto& grp: sec.groups_) {
+    groups_.offset.push_back(narrow(grp.offset()));
+    groups_.keys.push_back(narrow(keys_.key.size()));
+
+    for (const auto& kv: grp.entries()) {
+      keys_.key.push_back(store(kv.key()));
+      keys_.hash.push_back(static_cast<Offset>(key_hash(kv.key())));
+      keys_.value.push_back(store(kv.value_.content()));
+      keys_.key_offset.push_back(narrow(kv.key_offset()));
+      keys_.key_size.push_back(narrow(kv.key_size()));
+      keys_.value_offset.push_back(narrow(kv.value_offset()));
+      keys_.value_size.push_back(narrow(kv.value_size()));
+    }
+  }
+
+  for (const auto& subsec: sec.sections_) {
+    add(subsec, index);
+  }
+
+  sections_.end[index] = narrow(sections_.offset.size());
+}
+
+
+
+
+
+template<std::unsigned_integral Offset>
+std::vector<typename iconfigp::basic_frozen_document<Offset>::key_view>
+iconfigp::basic_frozen_document<Offset>::unused_keys() const {
+  std::vector<key_view> output;
+
+  for (size_t i = 0; i < section_count();) {
+    if (!sections_.used.test(i)) {
+      i = sections_.end[i];
+      continue;
+    }
+
+    for (size_t k = groups_.keys[sections_.groups[i]];
+        k < groups_.keys[sections_.groups[i + 1]]; ++k) {
+      if (!keys_.used.test(k)) {
+        output.emplace_back(*this, k);
+      }
+    }
+
+    ++i;
+  }
+
+  return output;
+}
+
+
+
+template<std::unsigned_integral Offset>
+std::vector<typename iconfigp::basic_frozen_document<Offset>::section_view>
+iconfigp::basic_frozen_document<Offset>::unused_sections() const {
+  std::vector<section_view> output;
+
+  for (size_t i = 0; i < section_count();) {
+    if (!sections_.used.test(i)) {
+      output.emplace_back(*this, i);
+      i = sections_.end[i];
+    } else {
+      ++i;
+    }
+  }
+
+  return output;
+}
+
+
+
+template<std::unsigned_integral Offset>
+size_t iconfigp::basic_frozen_document<Offset>::memory_usage() const {
+  return arena_.capacity()
+    + heap_size(sections_.name)     + heap_size(sections_.offset)
+    + heap_size(sections_.parent)   + heap_size(sections_.end)
+    + heap_size(sections_.groups)   + heap_size(sections_.slots)
+    + sections_.used.memory_usage()
+    + heap_size(groups_.offset)     + heap_size(groups_.keys)
+    + heap_size(keys_.key)          + heap_size(keys_.value)
+    + heap_size(keys_.key_offset)   + heap_size(keys_.key_size)
+    + heap_size(keys_.value_offset) + heap_size(keys_.value_size)
+    + heap_size(keys_.hash)         + keys_.used.memory_usage()
+    + heap_size(slots_);
+}
+
+
+
+template class iconfigp::basic_frozen_document<uint64_t>;
+template class iconfigp::basic_frozen_document<uint32_t>;
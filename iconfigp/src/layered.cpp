@@ -0,0 +1,159 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/layered.hpp"
+
+#include "iconfigp/find-config.hpp"
+#include "iconfigp/serialize.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace iconfigp;
+
+
+
+void iconfigp::overlay::add(const section& sec, size_t layer) {
+  offset_ = sec.offset_;
+
+  for (const auto& grp: sec.groups_) {
+    std::unordered_map<std::string_view, const key_value*> in_group;
+
+    for (const auto& kv: grp.entries()) {
+      auto [it, inserted] = keys_.try_emplace(kv.key(), entry{
+        .value       = &kv,
+        .conflict    = nullptr,
+        .per_section = false,
+        .layer       = layer
+      });
+
+      auto& ent = it->second;
+
+      if (inserted) {
+        in_group.emplace(kv.key(), &kv);
+
+      } else if (ent.layer != layer) {
+        ent = entry{
+          .value       = &kv,
+          .conflict    = nullptr,
+          .per_section = false,
+          .layer       = layer
+        };
+        in_group.emplace(kv.key(), &kv);
+
+      } else if (ent.conflict == nullptr) {
+        ent.conflict    = &kv;
+        ent.per_section = !in_group.contains(kv.key());
+      }
+    }
+  }
+
+  for (const auto& subsec: sec.sections_) {
+    auto& child = sections_[subsec.name_];
+    if (!child) {
+      child = std::make_unique<overlay>();
+    }
+    child->add(subsec, layer);
+  }
+}
+
+
+
+
+
+layered_config iconfigp::layered_config::load(
+    std::string_view name,
+    std::string      defaults,
+    std::string      overrides
+) {
+  layered_config config;
+
+  if (!defaults.empty()) {
+    config.add_string(layer_kind::defaults, std::move(defaults), "<defaults>");
+  }
+
+  auto user = find_config_file(name);
+  for (const auto& file: find_config_files(name)) {
+    config.add_file(file == user ? layer_kind::user : layer_kind::system, file);
+  }
+
+  config.add_environment(name);
+
+  if (!overrides.empty()) {
+    config.add_string(layer_kind::overrides, std::move(overrides), "<overrides>");
+  }
+
+  return config;
+}
+
+
+
+void iconfigp::layered_config::add_file(layer_kind kind, const std::filesystem::path& path) {
+  push(kind, [&path](document& doc, size_t base) { doc.load(path, base); });
+}
+
+
+
+void iconfigp::layered_config::add_string(
+    layer_kind  kind,
+    std::string content,
+    std::string name
+) {
+  push(kind, [&content, &name](document& doc, size_t base) {
+    doc.load_string(std::move(content), std::move(name), base);
+  });
+}
+
+
+
+void iconfigp::layered_config::add_environment(std::string_view name) {
+  auto overrides = find_environment_overrides(name);
+  if (overrides.empty()) {
+    return;
+  }
+
+  std::string content;
+
+  for (auto& entry: overrides) {
+    std::string path;
+    for (const auto& part: entry.section) {
+      if (!path.empty()) {
+        path.push_back('.');
+      }
+      path += serialize(part, "\n\".]");
+    }
+
+    key_value kv{located_string{std::move(entry.key)}, located_string{std::move(entry.value)}};
+
+    content += iconfigp::format("# {}\n[{}]\n{}\n", entry.variable, path, serialize(kv));
+  }
+
+  add_string(layer_kind::environment, std::move(content), "<environment>");
+}
+
+
+
+void iconfigp::layered_config::push(
+    layer_kind                                     kind,
+    const std::function<void(document&, size_t)>& load
+) {
+  document doc;
+
+  try {
+    load(doc, end_offset_);
+  } catch (...) {
+    // the sources stay available for formatting the exception, later layers must not
+    // reuse their offsets
+    const auto& failed = failed_.emplace_back(std::move(doc));
+    std::ranges::copy(failed.sources(), std::back_inserter(sources_));
+    end_offset_ = std::max(end_offset_, failed.end_offset());
+    throw;
+  }
+
+  std::ranges::copy(doc.sources(), std::back_inserter(sources_));
+  end_offset_ = doc.end_offset();
+
+  // moving the document keeps the strings its tree refers to in place
+  auto& current = layers_.emplace_back(layer{.kind = kind, .doc = std::move(doc)});
+  root_.add(current.doc.root(), layers_.size() - 1);
+}
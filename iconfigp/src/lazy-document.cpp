@@ -0,0 +1,122 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/lazy-document.hpp"
+
+#include "iconfigp/parser.hpp"
+
+#include <utility>
+
+
+
+iconfigp::lazy_document::lazy_document(std::string_view input, size_t base_offset) :
+  input_      {input},
+  base_offset_{base_offset}
+{
+  std::vector<std::pair<std::string, std::vector<range>>> found(1);
+  std::unordered_map<std::string, size_t>                 positions;
+
+  parser p{input, base_offset};
+
+  size_t current{0};
+  size_t start  {0};
+
+  while (p.skip_to_section()) {
+    size_t begin = p.reader_.offset() - base_offset;
+    found[current].second.push_back(range{.begin = start, .end = begin});
+    start = begin;
+
+    auto header = p.parse_section();
+
+    // a header like [] or [.a] selects the root section, see section::select_section
+    if (header.path.empty() || header.path.front().empty()) {
+      current = 0;
+      continue;
+    }
+
+    auto [it, inserted] = positions.try_emplace(header.path.front(), found.size());
+    if (inserted) {
+      found.emplace_back(std::move(header.path.front()), std::vector<range>{});
+    }
+    current = it->second;
+  }
+
+  found[current].second.push_back(range{.begin = start, .end = input.size()});
+
+
+
+  entries_ = std::vector<entry>(found.size());
+
+  for (size_t i = 0; i < found.size(); ++i) {
+    entries_[i].name   = std::move(found[i].first);
+    entries_[i].ranges = std::move(found[i].second);
+
+    if (i > 0) {
+      index_.emplace(entries_[i].name, i);
+    }
+  }
+}
+
+
+
+iconfigp::opt_ref<const iconfigp::section> iconfigp::lazy_document::subsection(
+    std::string_view name
+) const {
+  if (auto it = index_.find(name); it != index_.end()) {
+    return materialize(entries_[it->second]);
+  }
+  return {};
+}
+
+
+
+std::vector<std::string_view> iconfigp::lazy_document::section_names() const {
+  std::vector<std::string_view> names;
+  names.reserve(entries_.size() - 1);
+
+  for (size_t i = 1; i < entries_.size(); ++i) {
+    names.emplace_back(entries_[i].name);
+  }
+
+  return names;
+}
+
+
+
+bool iconfigp::lazy_document::materialized(std::string_view name) const {
+  if (auto it = index_.find(name); it != index_.end()) {
+    return entries_[it->second].done.load(std::memory_order_acquire);
+  }
+  return false;
+}
+
+
+
+const iconfigp::section& iconfigp::lazy_document::materialize(const entry& ent) const {
+  std::call_once(ent.once, [&] {
+    auto root = parse_ranges(ent.ranges);
+
+    if (&ent == &entries_.front()) {
+      ent.content = std::move(root);
+    } else {
+      ent.content = std::move(root.sections_.front());
+    }
+
+    ent.done.store(true, std::memory_order_release);
+  });
+
+  return *ent.content;
+}
+
+
+
+iconfigp::section iconfigp::lazy_document::parse_ranges(std::span<const range> ranges) const {
+  parser p{{}, base_offset_};
+
+  for (const auto& r: ranges) {
+    p.reset(input_.substr(r.begin, r.end - r.begin), base_offset_ + r.begin);
+    p.parse_input();
+  }
+
+  return std::move(p.root_);
+}
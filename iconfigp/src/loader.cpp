@@ -0,0 +1,302 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/loader.hpp"
+
+#include "iconfigp/exception.hpp"
+#include "iconfigp/parallel.hpp"
+#include "iconfigp/parser.hpp"
+#include "iconfigp/path.hpp"
+
+#include <cerrno>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <system_error>
+
+using namespace iconfigp;
+
+
+
+namespace {
+  // reading and parsing a file is worth a thread of its own, the number of threads is
+  // still bounded by the number of cores
+  constexpr size_t min_files_per_thread = 1;
+
+
+
+  // errno belongs to the thread which read the file, so the error travels with the result
+  struct read_result {
+    std::optional<std::string> content;
+    std::error_code            error;
+  };
+
+
+
+  [[nodiscard]] std::error_code last_error(std::errc fallback) {
+    return std::error_code{errno != 0 ? errno : static_cast<int>(fallback),
+                           std::generic_category()};
+  }
+
+
+
+  [[nodiscard]] read_result read_file(const std::filesystem::path& path) {
+    errno = 0;
+    std::ifstream input{path, std::ios::binary};
+    if (!input) {
+      return {.content = {}, .error = last_error(std::errc::no_such_file_or_directory)};
+    }
+
+    if (std::filesystem::is_directory(path)) {
+      return {.content = {}, .error = std::make_error_code(std::errc::is_a_directory)};
+    }
+
+    std::stringstream buffer;
+    buffer << input.rdbuf();
+
+    if (input.bad()) {
+      return {.content = {}, .error = last_error(std::errc::io_error)};
+    }
+
+    return {.content = std::move(buffer).str(), .error = {}};
+  }
+}
+
+
+
+
+
+class iconfigp::document::loader {
+  public:
+    explicit loader(document& doc) :
+      doc_{doc}
+    {}
+
+
+
+    void load(const std::filesystem::path& path, size_t base_offset) {
+      reset(base_offset);
+
+      request(std::filesystem::weakly_canonical(std::filesystem::absolute(path)), {});
+
+      resolve();
+    }
+
+
+
+    void load_string(std::string content, std::string name, size_t base_offset) {
+      reset(base_offset);
+
+      units_.push_back(unit{
+        .path         = std::move(name),
+        .directory    = std::filesystem::current_path(),
+        .content      = std::move(content),
+        .requested_by = {},
+        .root         = section{"", 0},
+        .includes     = {},
+        .status       = state::pending
+      });
+
+      resolve();
+    }
+
+
+
+  private:
+    void reset(size_t base_offset) {
+      doc_.root_ = section{"", base_offset};
+      doc_.sources_.clear();
+      doc_.contents_.clear();
+      doc_.end_offset_ = base_offset;
+    }
+
+
+
+    void resolve() {
+      for (size_t begin = 0; begin < units_.size();) {
+        size_t end = units_.size();
+        discover(begin, end);
+        begin = end;
+      }
+
+      doc_.root_ = std::move(expand(0, {}));
+    }
+
+
+
+    enum class state {
+      pending,
+      expanding,
+      done
+    };
+
+    struct unit {
+      std::filesystem::path         path;
+      std::filesystem::path         directory;
+      std::optional<std::string>    content;
+      std::optional<located_string> requested_by;
+
+      section                       root{"", 0};
+      std::vector<size_t>           includes;
+
+      state                         status{state::pending};
+    };
+
+
+
+    document&                               doc_;
+
+    std::deque<unit>                        units_;
+    std::map<std::filesystem::path, size_t> index_;
+
+
+
+    size_t request(const std::filesystem::path& path, std::optional<located_string> by) {
+      auto [it, inserted] = index_.try_emplace(path, units_.size());
+      if (inserted) {
+        units_.push_back(unit{
+          .path         = path,
+          .directory    = path.parent_path(),
+          .content      = {},
+          .requested_by = std::move(by),
+          .root         = section{"", 0},
+          .includes     = {},
+          .status       = state::pending
+        });
+      }
+      return it->second;
+    }
+
+
+
+    void discover(size_t begin, size_t end) {
+      std::vector<read_result> reads(end - begin);
+
+      detail::for_each_chunk(reads.size(), min_files_per_thread, true,
+          [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+              auto& current = units_[begin + i];
+              if (current.content) {
+                reads[i] = read_result{.content = std::move(current.content), .error = {}};
+              } else {
+                reads[i] = read_file(current.path);
+              }
+            }
+          });
+
+      for (size_t i = begin; i < end; ++i) {
+        auto& [content, error] = reads[i - begin];
+
+        if (!content) {
+          raise_unreadable(units_[i], error);
+        }
+
+        doc_.contents_.push_back(std::move(*content));
+        doc_.sources_.push_back(source_file{
+          .name    = units_[i].path.string(),
+          .content = doc_.contents_.back(),
+          .offset  = doc_.end_offset_
+        });
+        doc_.end_offset_ += doc_.contents_.back().size() + 1;
+      }
+
+
+
+      // the first failure in the order of the units is rethrown
+      detail::for_each_chunk(end - begin, min_files_per_thread, true,
+          [&](size_t first, size_t last) {
+            for (size_t i = begin + first; i < begin + last; ++i) {
+              const auto& source = doc_.sources_[i];
+              units_[i].root = parser::parse(source.content, source.offset);
+            }
+          });
+
+      for (size_t i = begin; i < end; ++i) {
+        collect(units_[i].root, i);
+      }
+    }
+
+
+
+    [[noreturn]] static void raise_unreadable(const unit& u, std::error_code error) {
+      if (!u.requested_by) {
+        throw std::filesystem::filesystem_error{"cannot read config file", u.path, error};
+      }
+
+      throw include_exception{include_error_type::unreadable, u.path.string(),
+        u.requested_by->offset(), u.requested_by->size()};
+    }
+
+
+
+    void collect(const section& sec, size_t index) {
+      for (const auto& subsec: sec.sections_) {
+        collect(subsec, index);
+      }
+
+      const auto& parent = units_[index].directory;
+
+      for (const auto& path: sec.includes_) {
+        auto resolved = std::filesystem::weakly_canonical(
+                          resolve_path(path.content(), parent));
+
+        auto target = request(resolved, path);
+        units_[index].includes.push_back(target);
+      }
+    }
+
+
+
+    section& expand(size_t index, const std::optional<located_string>& directive) {
+      auto& current = units_[index];
+
+      if (current.status == state::expanding) {
+        throw include_exception{include_error_type::cycle, current.path.string(),
+          directive->offset(), directive->size()};
+      }
+
+      if (current.status == state::pending) {
+        current.status = state::expanding;
+
+        size_t next{0};
+        apply(current.root, current, next);
+
+        current.status = state::done;
+      }
+
+      return current.root;
+    }
+
+
+
+    void apply(section& sec, const unit& current, size_t& next) {
+      for (auto& subsec: sec.sections_) {
+        apply(subsec, current, next);
+      }
+
+      for (const auto& path: sec.includes_) {
+        sec.merge(expand(current.includes[next++], path));
+      }
+
+      sec.includes_.clear();
+    }
+};
+
+
+
+
+
+void iconfigp::document::load(const std::filesystem::path& path, size_t base_offset) {
+  loader{*this}.load(path, base_offset);
+}
+
+
+
+void iconfigp::document::load_string(
+    std::string content,
+    std::string name,
+    size_t      base_offset
+) {
+  loader{*this}.load_string(std::move(content), std::move(name), base_offset);
+}
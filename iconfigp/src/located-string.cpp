@@ -0,0 +1,33 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/located-string.hpp"
+
+#include "iconfigp/reader.hpp"
+#include "iconfigp/stats.hpp"
+
+
+
+std::string_view iconfigp::located_string::decode() const {
+  if (!lazy_->done.load(std::memory_order_acquire)) {
+    std::call_once(lazy_->once, [this] {
+      // the token has been validated while parsing, decoding it cannot fail
+      lazy_->decoded = reader{lazy_->raw}.read_until_one_of("").take_string();
+      lazy_->done.store(true, std::memory_order_release);
+    });
+  }
+
+  return lazy_->decoded;
+}
+
+
+
+size_t iconfigp::located_string::heap_size() const {
+  switch (get_kind()) {
+    case kind::owned:  return detail::heap_size(owned_);
+    case kind::view:
+    case kind::pooled: return 0;
+    case kind::lazy:   return sizeof(lazy_token) + detail::heap_size(lazy_->decoded);
+  }
+  return 0;
+}
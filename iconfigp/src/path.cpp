@@ -1,5 +1,11 @@
 #include "iconfigp/path.hpp"
 
+#include "iconfigp/parallel.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <fcntl.h>
 #include <unistd.h>
 
 
@@ -36,15 +42,50 @@ std::optional<std::filesystem::path> iconfigp::preferred_root_path() {
 std::optional<std::filesystem::path> iconfigp::value_parser<std::filesystem::path>::parse(
     std::string_view input
 ) {
-  if (input.starts_with('~')) {
+  return resolve_path(input, preferred_root_path());
+}
+
+
+
+namespace {
+  constexpr size_t min_parallel_chunk = 256;
+
+
+
+  [[nodiscard]] std::optional<std::filesystem::path> home_path() {
     //NOLINTNEXTLINE(*-mt-unsafe)
     if (auto* home = getenv("HOME")) {
+      return std::filesystem::path{home};
+    }
+    return {};
+  }
+
+
+
+  [[nodiscard]] std::optional<std::filesystem::path> expand_home(
+      std::string_view                            input,
+      const std::optional<std::filesystem::path>& home
+  ) {
+    if (!input.starts_with('~') || !home) {
+      return {};
+    }
+
+    input.remove_prefix(1);
+    if (input.starts_with('/')) {
       input.remove_prefix(1);
-      if (input.starts_with('/')) {
-        input.remove_prefix(1);
-      }
-      return std::filesystem::path{home} / input;
     }
+    return *home / input;
+  }
+}
+
+
+
+std::filesystem::path iconfigp::resolve_path(
+    std::string_view                            input,
+    const std::optional<std::filesystem::path>& root
+) {
+  if (auto home = expand_home(input, home_path())) {
+    return *home;
   }
 
   std::filesystem::path path{input};
@@ -53,7 +94,7 @@ std::optional<std::filesystem::path> iconfigp::value_parser<std::filesystem::pat
     return path;
   }
 
-  if (auto root = preferred_root_path()) {
+  if (root) {
     if (auto abs = *root / input; std::filesystem::exists(abs)) {
       return abs;
     }
@@ -61,3 +102,95 @@ std::optional<std::filesystem::path> iconfigp::value_parser<std::filesystem::pat
 
   return std::filesystem::absolute(path);
 }
+
+
+
+
+
+iconfigp::path_resolver::path_resolver() :
+  path_resolver{preferred_root_path()}
+{}
+
+
+
+iconfigp::path_resolver::path_resolver(std::optional<std::filesystem::path> root) :
+  home_{home_path()},
+  cwd_ {std::filesystem::current_path()},
+  root_{std::move(root)}
+{
+  if (root_) {
+    //NOLINTNEXTLINE(*-vararg)
+    root_fd_ = open(root_->c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+  }
+}
+
+
+
+iconfigp::path_resolver::path_resolver(path_resolver&& other) noexcept :
+  home_   {std::move(other.home_)},
+  cwd_    {std::move(other.cwd_)},
+  root_   {std::move(other.root_)},
+  root_fd_{std::exchange(other.root_fd_, -1)}
+{}
+
+
+
+iconfigp::path_resolver& iconfigp::path_resolver::operator=(path_resolver&& other) noexcept {
+  if (this != &other) {
+    if (root_fd_ >= 0) {
+      close(root_fd_);
+    }
+
+    home_    = std::move(other.home_);
+    cwd_     = std::move(other.cwd_);
+    root_    = std::move(other.root_);
+    root_fd_ = std::exchange(other.root_fd_, -1);
+  }
+  return *this;
+}
+
+
+
+iconfigp::path_resolver::~path_resolver() {
+  if (root_fd_ >= 0) {
+    close(root_fd_);
+  }
+}
+
+
+
+std::filesystem::path iconfigp::path_resolver::resolve(std::string_view input) const {
+  if (auto home = expand_home(input, home_)) {
+    return *home;
+  }
+
+  std::filesystem::path path{input};
+
+  if (path.is_absolute()) {
+    return path;
+  }
+
+  if (root_fd_ >= 0 && faccessat(root_fd_, path.c_str(), F_OK, 0) == 0) {
+    return *root_ / path;
+  }
+
+  return cwd_ / path;
+}
+
+
+
+std::vector<std::filesystem::path> iconfigp::path_resolver::resolve(
+    std::span<const std::string_view> inputs,
+    bool                              parallel
+) const {
+  std::vector<std::filesystem::path> output(inputs.size());
+
+  detail::for_each_chunk(inputs.size(), min_parallel_chunk, parallel,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          output[i] = resolve(inputs[i]);
+        }
+      });
+
+  return output;
+}
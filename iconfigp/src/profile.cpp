@@ -0,0 +1,142 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/profile.hpp"
+
+#include "iconfigp/format.hpp"
+#include "iconfigp/section.hpp"
+
+#include <algorithm>
+#include <bit>
+
+
+
+//NOLINTBEGIN(*-global-variables)
+namespace { namespace global_state {
+  std::atomic<bool> latency_enabled{false};
+
+  std::array<std::atomic<uint64_t>, iconfigp::latency_buckets> latency{};
+}}
+//NOLINTEND(*-global-variables)
+
+
+
+bool iconfigp::detail::latency_enabled() {
+  return global_state::latency_enabled.load(std::memory_order_relaxed);
+}
+
+
+
+void iconfigp::detail::record_latency(std::chrono::nanoseconds duration) {
+  auto ns     = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(
+                  duration.count(), 1));
+  auto bucket = std::min<size_t>(std::bit_width(ns) - 1, latency_buckets - 1);
+
+  //NOLINTNEXTLINE(*-constant-array-index)
+  global_state::latency[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+
+void iconfigp::enable_latency_histogram(bool enable) {
+  global_state::latency_enabled.store(enable, std::memory_order_relaxed);
+}
+
+
+
+void iconfigp::reset_latency_histogram() {
+  for (auto& bucket: global_state::latency) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+
+
+std::array<uint64_t, iconfigp::latency_buckets> iconfigp::latency_histogram() {
+  std::array<uint64_t, latency_buckets> output{};
+
+  std::ranges::transform(global_state::latency, output.begin(),
+      [](const auto& bucket) { return bucket.load(std::memory_order_relaxed); });
+
+  return output;
+}
+
+
+
+
+
+void iconfigp::detail::collect_accesses(
+    const section&             sec,
+    const std::string&         path,
+    std::vector<access_entry>& output
+) {
+  if (sec.lookup_count() > 0 || sec.key_lookup_count() > 0) {
+    output.push_back(access_entry{
+      .path    = path,
+      .key     = {},
+      .offset  = sec.offset(),
+      .lookups = sec.lookup_count(),
+      .reads   = sec.key_lookup_count()
+    });
+  }
+
+  for (const auto& grp: sec.groups_) {
+    for (const auto& kv: grp.entries()) {
+      if (kv.lookup_count() > 0 || kv.read_count() > 0) {
+        output.push_back(access_entry{
+          .path    = path,
+          .key     = kv.key(),
+          .offset  = kv.key_offset(),
+          .lookups = kv.lookup_count(),
+          .reads   = kv.read_count()
+        });
+      }
+    }
+  }
+
+  for (const auto& subsec: sec.sections_) {
+    collect_accesses(subsec, path.empty() ? subsec.name_ : path + '.' + subsec.name_,
+        output);
+  }
+}
+
+
+
+std::vector<iconfigp::access_entry> iconfigp::access_report(
+    const section& root,
+    size_t         limit
+) {
+  std::vector<access_entry> output;
+  detail::collect_accesses(root, "", output);
+
+  std::ranges::stable_sort(output, std::ranges::greater{},
+      [](const auto& entry) { return entry.lookups + entry.reads; });
+
+  if (limit > 0 && output.size() > limit) {
+    output.resize(limit);
+  }
+
+  return output;
+}
+
+
+
+std::string iconfigp::format_access_report(std::span<const access_entry> entries) {
+  std::string output = iconfigp::format("{:>10} {:>10}  {}\n", "lookups", "reads", "key");
+
+  for (const auto& entry: entries) {
+    std::string name = entry.path;
+    if (!entry.key.empty()) {
+      if (!name.empty()) {
+        name.push_back('.');
+      }
+      name += entry.key;
+    } else {
+      name = "[" + name + "]";
+    }
+
+    output += iconfigp::format("{:>10} {:>10}  {}\n", entry.lookups, entry.reads, name);
+  }
+
+  return output;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/push-parser.hpp"
+
+
+
+void iconfigp::push_parser::feed(std::span<const char> chunk) {
+  buffer_.append(chunk.data(), chunk.size());
+  drain(false);
+}
+
+
+
+iconfigp::section iconfigp::push_parser::finish() {
+  drain(true);
+  return std::move(parser_.root_);
+}
+
+
+
+void iconfigp::push_parser::drain(bool final) {
+  std::string_view pending{buffer_};
+  size_t           consumed{0};
+
+  while (true) {
+    parser_.reset(pending.substr(consumed), offset_ + consumed);
+
+    try {
+      auto event = parser_.next_event();
+
+      if (!event) {
+        // everything up to the last line break is ignored, a comment after it might
+        // continue in the next chunk
+        if (auto line_end = pending.rfind('\n');
+            !final && line_end != std::string_view::npos && line_end >= consumed) {
+          consumed = line_end + 1;
+        }
+        break;
+      }
+
+      if (!final && parser_.reader_.eof()) {
+        break;
+      }
+
+      consumed = parser_.reader_.offset() - offset_;
+
+      parser_.build([&] {
+        std::visit([this](auto&& ev) { parser_.apply(std::move(ev)); }, *event);
+      });
+
+    } catch (const syntax_exception&) {
+      if (!final && parser_.reader_.eof()) {
+        break;
+      }
+      throw;
+    }
+  }
+
+  buffer_.erase(0, consumed);
+  offset_ += consumed;
+}
@@ -0,0 +1,231 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/schema.hpp"
+
+#include <array>
+#include <ranges>
+
+
+
+namespace {
+  [[nodiscard]] bool at_most_once(iconfigp::cardinality count) {
+    return count == iconfigp::cardinality::optional || count == iconfigp::cardinality::one;
+  }
+
+  [[nodiscard]] bool required(iconfigp::cardinality count) {
+    return count == iconfigp::cardinality::one ||
+      count == iconfigp::cardinality::at_least_one;
+  }
+
+
+
+  // the description may be a temporary, the exception must not refer to it
+  [[nodiscard]] iconfigp::cardinality parse_count(
+      iconfigp::opt_ref<const iconfigp::key_value> count
+  ) {
+    try {
+      return iconfigp::parse<iconfigp::cardinality>(count)
+        .value_or(iconfigp::cardinality::optional);
+    } catch (iconfigp::value_parse_exception& ex) {
+      ex.detach();
+      throw;
+    }
+  }
+}
+
+
+
+iconfigp::schema::schema(const section& description, std::span<const schema_type> types) :
+  root_{compile("", description, types)}
+{}
+
+
+
+iconfigp::schema::section_rule iconfigp::schema::compile(
+    std::string                  name,
+    const section&               description,
+    std::span<const schema_type> types
+) {
+  static const std::array builtin_types{
+    type<std::string_view>(), type<bool>(),
+    type<int8_t>(),  type<uint8_t>(),  type<int16_t>(), type<uint16_t>(),
+    type<int32_t>(), type<uint32_t>(), type<int64_t>(), type<uint64_t>(),
+    type<float>(),   type<double>(),   type<long double>()
+  };
+
+  auto find_type = [&](const key_value& kv) {
+    auto name_matches = [&kv](const auto& t) { return t.name == kv.value(); };
+
+    if (auto it = std::ranges::find_if(types, name_matches); it != types.end()) {
+      return it->check;
+    }
+    if (auto it = std::ranges::find_if(builtin_types, name_matches);
+        it != builtin_types.end()) {
+      return it->check;
+    }
+
+    std::string names;
+    for (const auto& t: builtin_types) {
+      names += names.empty() ? "(" : "|";
+      names += t.name;
+    }
+    for (const auto& t: types) {
+      names += "|";
+      names += t.name;
+    }
+
+    throw value_parse_exception{kv, "type", names + ")"};
+  };
+
+
+
+  section_rule rule{.name = std::move(name), .keys = {}, .key_index = {},
+                    .sections = {}, .section_index = {}};
+
+  std::vector<const key_value*> definitions;
+
+  for (const auto& grp: description.groups()) {
+    if (grp.empty()) {
+      continue;
+    }
+
+    const auto& key = grp.require_unique_key("key");
+
+    if (auto [it, inserted] = rule.key_index.try_emplace(std::string{key.value()},
+          rule.keys.size()); !inserted) {
+      throw multiple_definitions_exception{*definitions[it->second], key, true};
+    }
+    definitions.push_back(&key);
+
+    auto [type_name, count, fallback] = grp.unique_keys("type", "count", "default");
+
+    key_rule k{
+      .name     = std::string{key.value()},
+      .check    = type_name ? find_type(*type_name) : &check<std::string_view>,
+      .count    = parse_count(count),
+      .fallback = {}
+    };
+
+    if (fallback) {
+      k.check(*fallback);
+      k.fallback = std::string{fallback->value()};
+    }
+
+    rule.keys.push_back(std::move(k));
+  }
+
+  for (const auto& subsec: description.subsections()) {
+    rule.section_index.emplace(subsec.name(), rule.sections.size());
+    rule.sections.push_back(compile(std::string{subsec.name()}, subsec, types));
+  }
+
+  return rule;
+}
+
+
+
+iconfigp::validation_report iconfigp::schema::validate(section& root) const {
+  validation_report report;
+  validate(root_, root, report);
+  return report;
+}
+
+
+
+void iconfigp::schema::validate(
+    const section_rule& rule,
+    section&            sec,
+    validation_report&  report,
+    const std::string&  missing_path
+) {
+  std::vector<const key_value*> first(rule.keys.size(), nullptr);
+
+  for (const auto& grp: sec.groups_) {
+    for (const auto& kv: grp.values_) {
+      auto it = rule.key_index.find(kv.key());
+      if (it == rule.key_index.end()) {
+        report.errors.push_back(std::make_exception_ptr(unknown_key_exception{kv}));
+        continue;
+      }
+
+      const auto& k = rule.keys[it->second];
+
+      if (first[it->second] == nullptr) {
+        first[it->second] = &kv;
+      } else if (at_most_once(k.count)) {
+        report.errors.push_back(std::make_exception_ptr(
+              multiple_definitions_exception{*first[it->second], kv, true}));
+      }
+
+      try {
+        k.check(kv);
+      } catch (...) {
+        report.errors.push_back(std::current_exception());
+      }
+    }
+  }
+
+
+
+  for (size_t i = 0; i < rule.keys.size(); ++i) {
+    if (first[i] != nullptr) {
+      continue;
+    }
+
+    const auto& k = rule.keys[i];
+
+    if (k.fallback) {
+      // a section starting with a row has no group for the keys before the first row
+      if (!sec.leading_group_) {
+        sec.groups_.insert(sec.groups_.begin(), group{sec.offset_});
+        sec.leading_group_ = true;
+      }
+
+      sec.groups_.front().append(located_string{k.name, sec.offset_, 0},
+                                 located_string{*k.fallback, sec.offset_, 0});
+      sec.group_index_.clear();
+      report.defaults++;
+
+    } else if (required(k.count)) {
+      report.errors.push_back(std::make_exception_ptr(
+            missing_key_exception{missing_path + k.name, sec.offset_}));
+    }
+  }
+
+
+
+  std::vector<bool> present(rule.sections.size(), false);
+
+  for (auto& subsec: sec.sections_) {
+    auto it = rule.section_index.find(subsec.name_);
+    if (it == rule.section_index.end()) {
+      report.errors.push_back(std::make_exception_ptr(
+            unknown_section_exception{subsec.name_, subsec.offset_}));
+      continue;
+    }
+
+    present[it->second] = true;
+    validate(rule.sections[it->second], subsec, report);
+  }
+
+  for (size_t i = 0; i < rule.sections.size(); ++i) {
+    if (present[i]) {
+      continue;
+    }
+
+    section missing{rule.sections[i].name, sec.offset_};
+    // keys of missing sections are reported in the parent, by their path from there
+    validate(rule.sections[i], missing, report,
+        missing_path + rule.sections[i].name + '.');
+
+    if (!missing.groups_.front().empty() || !missing.sections_.empty()) {
+      // the current section of sec is referred to by sections_.size()
+      bool current = sec.current_section_ == sec.sections_.size();
+      sec.sections_.push_back(std::move(missing));
+      if (current) {
+        sec.current_section_ = sec.sections_.size();
+      }
+    }
+  }
+}
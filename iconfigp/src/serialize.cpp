@@ -24,8 +24,11 @@ std::string iconfigp::serialize(std::string_view input, std::string_view illegal
     return {};
   }
 
+  // unquoted, a backslash starts an escape sequence and a leading quotation mark a
+  // quoted string
   if (!is_space(input.front()) && !is_space(input.back()) &&
-      !contains_any_of(input, illegal)) {
+      input.front() != '\'' && input.front() != '"' &&
+      !contains_any_of(input, illegal) && !contains_any_of(input, "\\")) {
     return std::string{input};
   }
 
@@ -68,6 +71,10 @@ std::string iconfigp::serialize(
 
   auto output = iconfigp::format("{}[{}]\n", ind, name);
 
+  for (const auto& path: sec.includes()) {
+    output += iconfigp::format("{}@include {}\n", ind, serialize(path.content(), "\n\";["));
+  }
+
   bool written{false};
   for (const auto& grp: sec.groups()) {
     if (grp.empty()) {
@@ -116,10 +123,11 @@ std::string iconfigp::serialize(const group& gp, size_t indent) {
 std::string iconfigp::serialize(const key_value& kv) {
   bool bad_start = kv.key().starts_with('-')
     || kv.key().starts_with('[')
-    || kv.key().starts_with('#');
+    || kv.key().starts_with('#')
+    || kv.key().starts_with('@');
 
   return iconfigp::format("{} = {}",
-      serialize(kv.key(), bad_start ? "\n\"=#;-[" : "\n\"=;"),
+      serialize(kv.key(), bad_start ? "\n\"=#;-[@" : "\n\"=;"),
       serialize(kv.value(), "\n\";[")
   );
 }
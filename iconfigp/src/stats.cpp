@@ -0,0 +1,52 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/stats.hpp"
+
+#include "iconfigp/section.hpp"
+
+#include <string>
+#include <vector>
+
+
+
+size_t iconfigp::detail::heap_size(const std::string& str) {
+  const auto* begin = reinterpret_cast<const char*>(&str); //NOLINT(*reinterpret-cast)
+
+  //NOLINTNEXTLINE(*-pointer-arithmetic)
+  if (str.data() >= begin && str.data() < begin + sizeof(str)) {
+    return 0;
+  }
+  return str.capacity() + 1;
+}
+
+
+
+namespace {
+  using iconfigp::detail::heap_size;
+}
+
+
+
+size_t iconfigp::memory_usage(const section& sec) {
+  size_t total = heap_size(sec.name_) + heap_size(sec.sections_) + heap_size(sec.groups_)
+    + heap_size(sec.includes_) + sec.group_index_.memory_usage();
+
+  for (const auto& path: sec.includes_) {
+    total += path.heap_size();
+  }
+
+  for (const auto& grp: sec.groups_) {
+    total += heap_size(grp.values_);
+
+    for (const auto& kv: grp.values_) {
+      total += kv.key_.heap_size() + kv.value_.heap_size();
+    }
+  }
+
+  for (const auto& subsec: sec.sections_) {
+    total += memory_usage(subsec);
+  }
+
+  return total;
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/stream.hpp"
+
+#include "iconfigp/parser.hpp"
+
+#include <algorithm>
+
+
+
+namespace {
+  // a header like [a..b] selects section a, see section::select_section
+  [[nodiscard]] bool selects(
+      const std::vector<std::string>& header,
+      const std::vector<std::string>& path
+  ) {
+    auto length = std::ranges::find_if(header,
+        [](const auto& name) { return name.empty(); }) - header.begin();
+
+    return std::ranges::equal(std::span{header}.first(length), path);
+  }
+}
+
+
+
+iconfigp::generator<iconfigp::streamed_group> iconfigp::stream_groups(
+    std::string_view         input,
+    std::vector<std::string> path,
+    size_t                   base_offset
+) {
+  bool           active = path.empty();
+  streamed_group current{.offset = base_offset, .entries = {}};
+
+  for (auto& event: parser::events(input, base_offset)) {
+    if (auto* kv = std::get_if<key_value>(&event)) {
+      if (active) {
+        current.entries.emplace_back(std::move(*kv));
+      }
+      continue;
+    }
+
+    size_t offset{0};
+    if (auto* header = std::get_if<section_event>(&event)) {
+      offset = header->offset;
+    } else if (auto* separator = std::get_if<group_event>(&event)) {
+      offset = separator->offset;
+    } else {
+      continue;
+    }
+
+    if (active && !current.entries.empty()) {
+      co_yield std::move(current);
+    }
+
+    if (auto* header = std::get_if<section_event>(&event)) {
+      active = selects(header->path, path);
+    }
+
+    current = streamed_group{.offset = offset, .entries = {}};
+  }
+
+  if (active && !current.entries.empty()) {
+    co_yield std::move(current);
+  }
+}
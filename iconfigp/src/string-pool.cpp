@@ -0,0 +1,40 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/string-pool.hpp"
+
+#include "iconfigp/stats.hpp"
+
+
+
+const std::string& iconfigp::string_pool::intern(std::string_view str) {
+  std::lock_guard lock{mutex_};
+
+  if (auto it = strings_.find(str); it != strings_.end()) {
+    return *it;
+  }
+
+  return *strings_.emplace(str).first;
+}
+
+
+
+size_t iconfigp::string_pool::size() const {
+  std::lock_guard lock{mutex_};
+  return strings_.size();
+}
+
+
+
+size_t iconfigp::string_pool::memory_usage() const {
+  std::lock_guard lock{mutex_};
+
+  size_t total = strings_.bucket_count() * sizeof(void*);
+
+  for (const auto& str: strings_) {
+    // node overhead, plus the heap buffer if the string is not stored inline
+    total += sizeof(void*) + sizeof(std::string) + sizeof(size_t) + detail::heap_size(str);
+  }
+
+  return total;
+}
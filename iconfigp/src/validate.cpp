@@ -0,0 +1,198 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+#include "iconfigp/validate.hpp"
+
+#include "iconfigp/parallel.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+
+namespace {
+  struct target {
+    const iconfigp::section*         sec;    // deepest existing section of the path
+    std::span<const iconfigp::group> groups; // empty if the path does not exist
+  };
+
+
+
+  [[nodiscard]] target resolve(
+      const iconfigp::section&  root,
+      const iconfigp::key_path& path
+  ) {
+    const auto* sec = &root;
+
+    for (const auto& name: path.sections()) {
+      auto next = sec->subsection(name);
+      if (!next) {
+        return {.sec = sec, .groups = {}};
+      }
+      sec = &*next;
+    }
+
+    return {.sec = sec, .groups = sec->groups()};
+  }
+
+
+
+  // same lookup as section::unique_key, but reports errors instead of throwing them
+  [[nodiscard]] std::exception_ptr check(
+      const iconfigp::key_expectation& expectation,
+      const target&                    tgt
+  ) {
+    auto key = expectation.path.key();
+
+    const iconfigp::key_value* found{nullptr};
+
+    for (const auto& grp: tgt.groups) {
+      const iconfigp::key_value* in_group{nullptr};
+
+      for (const auto& kv: grp.entries()) {
+        if (kv.key() != key) {
+          continue;
+        }
+        if (in_group != nullptr) {
+          return std::make_exception_ptr(
+              iconfigp::multiple_definitions_exception{*in_group, kv, false});
+        }
+        in_group = &kv;
+      }
+
+      if (in_group != nullptr) {
+        if (found != nullptr) {
+          return std::make_exception_ptr(
+              iconfigp::multiple_definitions_exception{*found, *in_group, true});
+        }
+        found = in_group;
+      }
+    }
+
+    if (found == nullptr) {
+      if (expectation.required) {
+        return std::make_exception_ptr(
+            iconfigp::missing_key_exception{std::string{key}, tgt.sec->offset()});
+      }
+      return {};
+    }
+
+    if (auto error = expectation.check(*found)) {
+      // the report may outlive the tree
+      auto ex = error->to_exception();
+      ex.detach();
+      return std::make_exception_ptr(std::move(ex));
+    }
+
+    return {};
+  }
+
+
+
+  constexpr size_t min_parallel_chunk = 256;
+
+
+
+  using definition_map = std::unordered_map<std::string_view, const iconfigp::key_value*>;
+}
+
+
+
+iconfigp::validation_report iconfigp::validate_all(
+    const section&                   root,
+    std::span<const key_expectation> expectations,
+    bool                             parallel
+) {
+  // sections are resolved up front since looking them up marks them as used
+  std::vector<target> targets;
+  targets.reserve(expectations.size());
+
+  // expectations of the same key are checked by the same thread, which is the only one
+  // marking that key as used
+  std::map<std::pair<const section*, std::string_view>, std::vector<size_t>> keys;
+
+  for (size_t i = 0; i < expectations.size(); ++i) {
+    targets.push_back(resolve(root, expectations[i].path));
+    keys[{targets.back().sec, expectations[i].path.key()}].push_back(i);
+  }
+
+  std::vector<const std::vector<size_t>*> tasks;
+  tasks.reserve(keys.size());
+  for (const auto& [_, indices]: keys) {
+    tasks.push_back(&indices);
+  }
+
+
+
+  std::vector<std::exception_ptr> errors(expectations.size());
+
+  detail::for_each_chunk(tasks.size(), min_parallel_chunk, parallel,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          for (auto index: *tasks[i]) {
+            errors[index] = check(expectations[index], targets[index]);
+          }
+        }
+      });
+
+
+
+  validation_report report;
+  std::ranges::copy_if(errors, std::back_inserter(report.errors),
+      [](const auto& error) { return static_cast<bool>(error); });
+
+  return report;
+}
+
+
+
+
+std::vector<iconfigp::multiple_definitions_exception> iconfigp::audit_duplicates(
+    const section& root,
+    bool           per_section
+) {
+  std::vector<multiple_definitions_exception> output;
+
+  definition_map in_group;
+  definition_map in_section;
+
+  std::vector<const section*> pending{&root};
+
+  while (!pending.empty()) {
+    const auto* sec = pending.back();
+    pending.pop_back();
+
+    in_section.clear();
+
+    for (const auto& grp: sec->groups_) {
+      in_group.clear();
+
+      for (const auto& kv: grp.entries()) {
+        auto [it, inserted] = in_group.try_emplace(kv.key(), &kv);
+        if (!inserted) {
+          output.emplace_back(*it->second, kv, false);
+          continue;
+        }
+
+        if (per_section) {
+          if (auto [jt, first] = in_section.try_emplace(kv.key(), &kv); !first) {
+            output.emplace_back(*jt->second, kv, true);
+          }
+        }
+      }
+    }
+
+    for (const auto& subsec: sec->sections_ | std::views::reverse) {
+      pending.push_back(&subsec);
+    }
+  }
+
+  return output;
+}
@@ -0,0 +1,94 @@
+#include "generated-config.hpp"
+
+#include <iconfigp/parser.hpp>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <cassert>
+
+
+
+static_assert(std::is_same_v<decltype(generated_config::poll_rate_ms), uint32_t>);
+static_assert(std::is_same_v<decltype(generated_config::verbose), std::optional<bool>>);
+static_assert(std::is_same_v<decltype(generated_config::tags), std::vector<std::string>>);
+static_assert(std::is_same_v<decltype(generated_config::panels_section::anchor),
+                             std::vector<std::string>>);
+
+
+
+namespace {
+  template<typename Exception>
+  void expect_error(std::string_view input) {
+    try {
+      std::ignore = parse_generated_config(iconfigp::parser::parse(input));
+      throw std::runtime_error{"expected exception"};
+    } catch (const Exception&) {
+    }
+  }
+
+
+
+  // same as iconfigp::schema, keys of missing sections are reported by their path
+  [[nodiscard]] std::string missing_key(std::string_view input) {
+    try {
+      std::ignore = parse_generated_config(iconfigp::parser::parse(input));
+    } catch (const iconfigp::missing_key_exception& ex) {
+      return std::string{ex.key()};
+    }
+    throw std::runtime_error{"expected missing key"};
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  auto config = parse_generated_config(iconfigp::parser::parse(R"(
+    name = main
+    verbose = yes
+    tags = a; tags = b
+
+    [panels]
+    - anchor = top; size = 20
+    - anchor = bottom
+
+    [panels.left]
+    width = -3
+  )"));
+
+  assert(config.poll_rate_ms == 100);
+  assert(config.name == "main");
+  assert(config.scale == 1.5F);
+  assert(config.verbose == true);
+  assert((config.tags == std::vector<std::string>{"a", "b"}));
+  assert((config.panels.anchor == std::vector<std::string>{"top", "bottom"}));
+  assert(config.panels.size == 20);
+  assert(config.panels.left.width == -3);
+
+  auto defaults = parse_generated_config(iconfigp::parser::parse(
+        "name = x\n[panels]\nanchor = top\n[panels.left]\nwidth = 1"));
+  assert(!defaults.verbose);
+  assert((defaults.tags == std::vector<std::string>{"none"}));
+  assert(std::isinf(defaults.limit) && defaults.limit > 0);
+  assert(std::isinf(defaults.lower) && defaults.lower < 0);
+  assert(std::isnan(defaults.ratio));
+  assert(defaults.minimum == std::numeric_limits<int64_t>::min());
+  assert(defaults.step == 3.0F);
+
+
+
+  expect_error<iconfigp::missing_key_exception>("[panels]\nanchor = a\n[panels.left]\nwidth=1");
+  expect_error<iconfigp::missing_key_exception>("name = x\n[panels]\nanchor = a");
+  expect_error<iconfigp::missing_key_exception>("name = x");
+
+  assert(missing_key("name = x") == "panels.anchor");
+  assert(missing_key("name = x\n[panels]\nanchor = a") == "left.width");
+  assert(missing_key("[panels]\nanchor = a\n[panels.left]\nwidth=1") == "name");
+  expect_error<iconfigp::multiple_definitions_exception>("name = x; name = y");
+  expect_error<iconfigp::value_parse_exception>("name = x; poll-rate-ms = -1");
+  expect_error<iconfigp::unknown_key_exception>("name = x; other = 1");
+  expect_error<iconfigp::unknown_section_exception>("name = x\n[other]");
+}
@@ -0,0 +1,52 @@
+#include <iconfigp/columns.hpp>
+#include <iconfigp/exception.hpp>
+#include <iconfigp/parser.hpp>
+
+#include <string>
+
+#include <cassert>
+
+
+
+int main() { // NOLINT(*exception-escape)
+  std::string input{"[items]\n"};
+  for (size_t i = 0; i < 5000; ++i) {
+    input += "- item = " + std::to_string(i) + "; enabled = " + (i % 2 == 0 ? "yes" : "no");
+    if (i % 1000 == 999) {
+      input += "; item = " + std::to_string(i);
+    }
+    input += '\n';
+  }
+  input += "- enabled = maybe\n";
+
+  auto root  = iconfigp::parser::parse(input);
+  auto items = root.subsection("items").value();
+
+  for (bool parallel: {false, true}) {
+    auto table = iconfigp::extract_columns<int, bool>(items, {"item", "enabled"}, parallel);
+
+    assert(table.rows() == 5001);
+    assert(table.column<0>()[42] == 42);
+    assert(table.column<1>()[42] == true);
+    assert(table.column<1>()[43] == false);
+
+    assert(table.errors.size() == 6);
+    for (size_t i = 0; i < 5; ++i) {
+      assert(table.errors[i].row == i * 1000 + 999);
+      assert(!table.column<0>()[table.errors[i].row]);
+
+      try {
+        std::rethrow_exception(table.errors[i].error);
+      } catch (const iconfigp::multiple_definitions_exception& ex) {
+        assert(!ex.per_section());
+      }
+    }
+
+    assert(table.errors[5].row == 5000);
+    try {
+      std::rethrow_exception(table.errors[5].error);
+    } catch (const iconfigp::value_parse_exception& ex) {
+      assert(ex.value().value() == "maybe");
+    }
+  }
+}
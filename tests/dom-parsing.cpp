@@ -1,5 +1,8 @@
 #include "iconfigp/exception.hpp"
 #include <iconfigp/parser.hpp>
+#include <iconfigp/serialize.hpp>
+#include <iconfigp/stats.hpp>
+#include <iconfigp/value-parser.hpp>
 
 #include <iostream>
 
@@ -35,7 +38,131 @@ dither= 0
 )";
 
 
-int main() { // NOLINT(readability-function-cognitive-complexity)
+namespace {
+  void test_unique_keys(const iconfigp::section& root) {
+    const auto& panels = root.subsection("panels").value();
+
+    auto [anchor, margin, missing] = panels.unique_keys("anchor", "margin", "missing");
+    assert(anchor->value() == "lbr" && margin->value() == "0" && !missing);
+
+    auto [zero, none] = iconfigp::parse_keys<int, bool>(panels, "margin", "missing");
+    assert(zero == 0 && !none);
+
+    try {
+      std::ignore = root.subsection("wallpaper").value().unique_keys("path", "filter");
+      assert(false);
+    } catch (const iconfigp::multiple_definitions_exception& ex) {
+      assert(ex.per_section() && ex.definition1().value() == "box-blur");
+    }
+  }
+
+
+
+  void test_find_groups(const iconfigp::section& root) {
+    const auto& wallpaper = root.subsection("wallpaper").value();
+
+    for (size_t repeat = 0; repeat < 2; ++repeat) {
+      auto lens = wallpaper.find_groups("filter", "lens-blur");
+      assert(lens.size() == 1);
+      assert(wallpaper.groups()[lens[0]].unique_key("radius")->value() == "128");
+    }
+    assert(wallpaper.find_groups("filter", "none").empty());
+    assert(wallpaper.find_groups("missing", "").empty());
+
+    auto copy = wallpaper;
+    assert(copy.find_groups("filter", "lens-blur").size() == 1);
+    static_assert(sizeof(iconfigp::group_index) == sizeof(void*));
+  }
+
+
+
+  void test_stats() {
+    iconfigp::parse_stats stats;
+    auto counted = iconfigp::parser::parse(example, stats);
+
+    assert(stats.bytes_scanned == example.size());
+    assert(stats.sections      == 4);
+    assert(stats.groups        == 8);
+    assert(stats.keys          == 22);
+    assert(stats.quotes        == 2);
+    assert(stats.escapes       == 0);
+    assert(stats.max_depth     == 2);
+    assert(stats.tree_bytes    == iconfigp::memory_usage(counted));
+    assert(stats.tree_bytes    >  0);
+
+    auto before = iconfigp::memory_usage(counted);
+    std::ignore = counted.subsection("panels").value().find_groups("anchor", "lbr");
+    assert(iconfigp::memory_usage(counted) > before);
+
+    auto plain    = iconfigp::parser::parse("a = 1\n");
+    auto included = iconfigp::parser::parse("a = 1\n@include some/long/path/file.ini\n");
+    assert(included.includes().size() == 1);
+    assert(iconfigp::memory_usage(included) > iconfigp::memory_usage(plain)
+        + included.includes().front().content().size());
+  }
+
+
+
+  void test_string_pool() {
+    iconfigp::parse_stats stats;
+    auto owned = iconfigp::parser::parse(example, stats);
+
+    iconfigp::string_pool pool;
+    auto first  = iconfigp::parser::parse(example, pool);
+    auto second = iconfigp::parser::parse(example, pool);
+
+    assert(pool.size() > 0);
+    assert(pool.size() < 2 * stats.keys);
+    assert(iconfigp::memory_usage(first) <= iconfigp::memory_usage(owned));
+
+    const auto& key1 = first.subsection("panels").value().groups().front().entries().front();
+    const auto& key2 = second.subsection("panels").value().groups().front().entries().front();
+    assert(key1.key().data() == key2.key().data());
+    assert(key1.value() == key2.value());
+
+    // interned strings do not need more room than owned ones
+    static_assert(sizeof(iconfigp::located_string) == sizeof(std::string) + 2 * sizeof(size_t));
+
+    iconfigp::string_pool short_pool;
+    iconfigp::string_pool long_pool;
+    std::ignore = short_pool.intern(std::string(1, 'x'));
+    std::ignore = long_pool.intern(std::string(20, 'x'));
+    assert(long_pool.memory_usage() >= short_pool.memory_usage() + 21);
+  }
+
+
+
+  void test_lazy_decoding() {
+    auto lazy = iconfigp::parser::parse(example, iconfigp::value_decoding::lazy);
+    assert(iconfigp::serialize(lazy) == iconfigp::serialize(iconfigp::parser::parse(example)));
+
+    std::string_view escaped{R"(
+      plain = value with spaces   ; trailing = a\ \n
+      quoted = "a \"quoted\" [value]"  ; single = 'raw \n'
+      empty = ; newline = line\nbreak
+    )"};
+
+    auto eager   = iconfigp::parser::parse(escaped);
+    auto decoded = iconfigp::parser::parse(escaped, iconfigp::value_decoding::lazy);
+
+    // copies of undecoded strings decode on their own, moved strings keep their token
+    auto copied = decoded;
+    auto moved  = std::move(copied);
+    assert(iconfigp::serialize(moved) == iconfigp::serialize(eager));
+
+    const auto& lazy_entries = decoded.groups().front().entries();
+    for (size_t i = 0; i < lazy_entries.size(); ++i) {
+      const auto& expected = eager.groups().front().entries()[i];
+      assert(lazy_entries[i].value()        == expected.value());
+      assert(lazy_entries[i].value_offset() == expected.value_offset());
+      assert(lazy_entries[i].value_size()   == expected.value_size());
+    }
+  }
+}
+
+
+
+int main() { // NOLINT(readability-function-cognitive-complexity,*exception-escape)
   try {
     auto root = iconfigp::parser::parse(example);
 
@@ -91,4 +218,12 @@ int main() { // NOLINT(readability-function-cognitive-complexity)
 
 
 
+  // outside of the try blocks above, unexpected exceptions fail the test
+  auto root = iconfigp::parser::parse(example);
+
+  test_unique_keys(root);
+  test_find_groups(root);
+  test_stats();
+  test_string_pool();
+  test_lazy_decoding();
 }
@@ -0,0 +1,166 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/frozen-document.hpp>
+#include <iconfigp/key-path.hpp>
+#include <iconfigp/key.hpp>
+#include <iconfigp/parser.hpp>
+
+#include <stdexcept>
+
+#include <cassert>
+
+
+
+static constexpr std::string_view example = R"(
+rate = 100
+
+[server]
+host = localhost
+port = 8080
+- port = 8081
+
+[server.tls]
+cert = "a b"
+
+[client]
+retries = 3
+- retries = 4
+[client.proxy]
+url = none
+)";
+
+
+
+using namespace iconfigp::literals;
+
+static_assert("timeout"_key.hash() == iconfigp::key_hash("timeout"));
+
+
+
+template<typename Document>
+void test_document(const iconfigp::section& tree) {
+  Document frozen{tree};
+
+  assert(frozen.section_count() == 5);
+  assert(frozen.key_count()     == 8);
+
+  auto root = frozen.root();
+  assert(iconfigp::parse<int>(root.require_unique_key("rate")) == 100);
+  assert(!root.parent());
+
+  auto server = root.subsection("server").value();
+  assert(server.name() == "server");
+  assert(server.unique_key("host").value().value() == "localhost");
+  assert(server.unique_key("host"_key)->index() == server.unique_key("host")->index());
+  assert(!server.unique_key("missing"_key));
+  assert(server.count_keys("port") == 2);
+  assert(server.parent()->index() == 0);
+
+  try {
+    std::ignore = server.unique_key("port");
+    throw std::runtime_error{"expected multiple definitions"};
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    assert(ex.per_section());
+    assert(ex.definition1().value() == "8080");
+  }
+
+  auto tls = server.subsection("tls").value();
+  assert(tls.unique_key("cert").value().value() == "a b");
+  assert(tls.parent()->name() == "server");
+
+  size_t names{0};
+  for (auto sec: root.subsections()) {
+    assert(sec.name() == "server" || sec.name() == "client");
+    names++;
+  }
+  assert(names == 2);
+
+  auto client = root.subsection("client").value();
+  size_t groups{0};
+  for (auto grp: client.groups()) {
+    if (!grp.empty()) {
+      assert(grp.unique_key("retries"));
+      groups++;
+    }
+  }
+  assert(groups == 2);
+
+  try {
+    std::ignore = client.require_unique_key("missing");
+    throw std::runtime_error{"expected missing key"};
+  } catch (const iconfigp::missing_key_exception& ex) {
+    assert(ex.offset() == client.offset());
+  }
+
+  auto unused = frozen.unused_keys();
+  assert(unused.size() == 4);
+  assert(unused[0].key() == "port"    && unused[1].key() == "port");
+  assert(unused[2].key() == "retries" && unused[3].key() == "retries");
+
+  assert(frozen.unused_sections().size() == 1);
+  assert(frozen.unused_sections().front().name() == "proxy");
+
+  assert(frozen.memory_usage() > 0);
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  auto tree = iconfigp::parser::parse(example);
+
+  test_document<iconfigp::frozen_document>(tree);
+  test_document<iconfigp::compact_frozen_document>(tree);
+
+  assert(iconfigp::compact_frozen_document{tree}.memory_usage()
+      < iconfigp::frozen_document{tree}.memory_usage());
+
+
+
+  iconfigp::key_path cert{"server.tls.cert"};
+  assert(cert.sections().size() == 2 && cert.key() == "cert");
+
+  iconfigp::frozen_document first{tree};
+  assert(cert.resolve(first)->value() == "a b");
+  assert(cert.resolve(first)->index() == cert.resolve(first)->index());
+  assert(first.generation() != iconfigp::frozen_document{tree}.generation());
+
+  iconfigp::frozen_document moved{iconfigp::parser::parse("[server.tls]\nx = 1\ncert = c\n")};
+  assert(cert.resolve(moved)->value() == "c");
+
+  iconfigp::frozen_document removed{iconfigp::parser::parse("[server]\ncert = c\n")};
+  assert(!cert.resolve(removed));
+  assert(!cert.resolve(removed));
+
+  try {
+    std::ignore = cert.require(removed);
+    throw std::runtime_error{"expected missing key"};
+  } catch (const iconfigp::missing_key_exception& ex) {
+    assert(ex.offset() == removed.root().subsection("server")->offset());
+  }
+
+  assert(iconfigp::key_path{"rate"}.resolve(first)->value() == "100");
+
+
+
+  std::string many;
+  for (size_t i = 0; i < 1000; ++i) {
+    many += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+  }
+  many += "key7 = again\n";
+
+  iconfigp::compact_frozen_document indexed{iconfigp::parser::parse(many)};
+  for (size_t i = 0; i < 1000; ++i) {
+    if (i == 7) {
+      continue;
+    }
+    auto kv = indexed.root().require_unique_key("key" + std::to_string(i));
+    assert(kv.value() == std::to_string(i));
+  }
+
+  try {
+    std::ignore = indexed.root().unique_key("key7"_key);
+    throw std::runtime_error{"expected multiple definitions"};
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    assert(!ex.per_section());
+    assert(ex.definition2().value() == "again");
+  }
+}
@@ -0,0 +1,167 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/loader.hpp>
+#include <iconfigp/parser.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <cassert>
+
+
+
+namespace {
+  class temp_dir {
+    public:
+      temp_dir() :
+        path_{std::filesystem::temp_directory_path() / "iconfigp-include-test"}
+      {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_ / "fragments");
+      }
+
+      temp_dir(const temp_dir&) = delete;
+      temp_dir(temp_dir&&)      = delete;
+      temp_dir& operator=(const temp_dir&) = delete;
+      temp_dir& operator=(temp_dir&&)      = delete;
+
+      ~temp_dir() {
+        std::filesystem::remove_all(path_);
+      }
+
+      [[nodiscard]] const std::filesystem::path& path() const { return path_; }
+
+      void write(const std::filesystem::path& name, std::string_view content) const {
+        std::ofstream{path_ / name} << content;
+      }
+
+    private:
+      std::filesystem::path path_;
+  };
+
+
+
+  template<typename Exception>
+  void expect_exception(const std::filesystem::path& path) {
+    iconfigp::document doc;
+    try {
+      doc.load(path);
+    } catch (const Exception& ex) {
+      std::cout << iconfigp::format_exception(ex, doc.sources(), true) << std::flush;
+      return;
+    }
+    throw std::runtime_error{"expected an exception while loading " + path.string()};
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  temp_dir dir;
+
+  dir.write("config.ini",
+      "global = 1\n"
+      "@include fragments/panels.ini\n"
+      "[wallpaper]\n"
+      "@include 'fragments/common.ini'\n"
+      "path = background.png\n"
+      "[other]\n"
+      "@include fragments/common.ini\n");
+
+  dir.write("fragments/panels.ini",
+      "[panels]\n"
+      "- anchor = lbr\n"
+      "- anchor = trl\n"
+      "@include common.ini\n");
+
+  dir.write("fragments/common.ini",
+      "color = #000000\n"
+      "[nested]\n"
+      "key = value\n");
+
+
+
+  iconfigp::document doc;
+  doc.load(dir.path() / "config.ini");
+
+  const auto& root = doc.root();
+
+  assert(doc.sources().size() == 3);
+  assert(root.includes().empty());
+
+  assert(root.unique_key("global").value().value() == "1");
+
+  auto panels = root.subsection("panels").value();
+  assert(panels.count_keys("anchor") == 2);
+  assert(panels.unique_key("color").value().value() == "#000000");
+  assert(panels.subsection("nested").value().unique_key("key").value().value() == "value");
+
+  auto wallpaper = root.subsection("wallpaper").value();
+  assert(wallpaper.unique_key("path").value().value() == "background.png");
+  assert(wallpaper.unique_key("color").value().value() == "#000000");
+
+  assert(root.subsection("other").value().subsection("nested"));
+
+
+
+  auto color = wallpaper.unique_key("color").value();
+  auto common = std::ranges::find_if(doc.sources(),
+      [](const auto& file) { return file.name.ends_with("common.ini"); });
+  assert(common != doc.sources().end());
+  assert(color.key_offset() == common->offset);
+
+
+
+  dir.write("fragments/defaults.ini", "key = 1\n");
+  dir.write("duplicate.ini",
+      "key = 0\n"
+      "@include fragments/defaults.ini\n");
+
+  iconfigp::document dup;
+  dup.load(dir.path() / "duplicate.ini");
+  try {
+    std::ignore = dup.root().unique_key("key");
+    throw std::runtime_error{"expected multiple definitions"};
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    auto message = iconfigp::format_exception(ex, dup.sources());
+    assert(message.find("defaults.ini") != std::string::npos);
+    std::cout << message << std::flush;
+  }
+
+
+
+  dir.write("cycle-a.ini", "a = 1\n@include cycle-b.ini\n");
+  dir.write("cycle-b.ini", "b = 1\n@include cycle-a.ini\n");
+  expect_exception<iconfigp::include_exception>(dir.path() / "cycle-a.ini");
+
+  dir.write("missing.ini", "@include does-not-exist.ini\n");
+  expect_exception<iconfigp::include_exception>(dir.path() / "missing.ini");
+
+  dir.write("syntax.ini", "@include fragments/broken.ini\n");
+  dir.write("fragments/broken.ini", "key = 'unterminated\n");
+  expect_exception<iconfigp::syntax_exception>(dir.path() / "syntax.ini");
+
+  dir.write("empty.ini", "@include\n");
+  expect_exception<iconfigp::syntax_exception>(dir.path() / "empty.ini");
+
+  for (const auto& [name, code]: {
+      std::pair{"does-not-exist.ini", std::errc::no_such_file_or_directory},
+      std::pair{"fragments",          std::errc::is_a_directory}}) {
+    try {
+      iconfigp::document doc;
+      doc.load(dir.path() / name);
+      throw std::runtime_error{"expected an unreadable file"};
+    } catch (const std::filesystem::filesystem_error& ex) {
+      assert(ex.code() == code);
+    }
+  }
+
+
+
+  auto plain = iconfigp::parser::parse("@include other.ini\n[section]\n@include a.ini;b=1");
+  assert(plain.includes().size() == 1);
+  assert(plain.includes()[0].content() == "other.ini");
+  assert(plain.subsection("section").value().includes()[0].content() == "a.ini");
+  assert(plain.subsection("section").value().unique_key("b"));
+}
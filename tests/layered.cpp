@@ -0,0 +1,166 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/find-config.hpp>
+#include <iconfigp/layered.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+#include <cassert>
+#include <cstdlib>
+
+
+
+namespace {
+  void write(const std::filesystem::path& path, std::string_view content) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream{path} << content;
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  auto dir = std::filesystem::temp_directory_path() / "iconfigp-layered-test";
+  std::filesystem::remove_all(dir);
+
+  write(dir / "system1/myapp/config.ini", "[server]\nport = 1\nhost = system1\n");
+  write(dir / "system2/myapp/config.ini", "[server]\nport = 2\nthreads = 4\n");
+  write(dir / "home/myapp/config.ini",    "[server]\nport = 3\n[client]\nretries = 5\n");
+
+  auto system_dirs = (dir / "system1").string() + ":" + (dir / "system2").string();
+
+  //NOLINTBEGIN(*mt-unsafe)
+  setenv("XDG_CONFIG_DIRS", system_dirs.c_str(), 1);
+  setenv("XDG_CONFIG_HOME", (dir / "home").c_str(), 1);
+  unsetenv("MYAPP_CONFIG");
+  setenv("MYAPP__SERVER__HOST",            "environment", 1);
+  setenv("MYAPP__CLIENT__MAX_RETRIES",     " 9 ",         1);
+  setenv("MYAPP__A__B__C",                 "nested",      1);
+  setenv("MYAPP__INVALID____KEY",          "ignored",     1);
+  setenv("MYAPP__PATHS__WINDOWS",          R"(C:\dir\x)", 1);
+  setenv("MYAPP__PATHS__QUOTED",           "'single",     1);
+  setenv("MYAPP__PATHS__DOUBLE",           R"("a" b)",    1);
+  //NOLINTEND(*mt-unsafe)
+
+  auto env = iconfigp::find_environment_overrides("MyApp");
+  assert(env.size() == 6);
+  for (const auto& entry: env) {
+    if (entry.variable == "MYAPP__CLIENT__MAX_RETRIES") {
+      assert(entry.section == std::vector<std::string>{"client"});
+      assert(entry.key     == "max-retries");
+      assert(entry.value   == " 9 ");
+    } else if (entry.variable == "MYAPP__A__B__C") {
+      assert((entry.section == std::vector<std::string>{"a", "b"}));
+      assert(entry.key     == "c");
+    }
+  }
+
+  auto files = iconfigp::find_config_files("MyApp");
+  assert(files.size() == 3);
+  assert(files[0] == dir / "system2/myapp/config.ini");
+  assert(files[1] == dir / "system1/myapp/config.ini");
+  assert(files[2] == dir / "home/myapp/config.ini");
+
+
+
+  auto config = iconfigp::layered_config::load("MyApp",
+      "[server]\nport = 0\ntimeout = 30\n",
+      "[client]\nretries = 7\n");
+
+  assert(config.layer_count() == 6);
+  assert(config.layer_at(0).kind == iconfigp::layer_kind::defaults);
+  assert(config.layer_at(1).kind == iconfigp::layer_kind::system);
+  assert(config.layer_at(3).kind == iconfigp::layer_kind::user);
+  assert(config.layer_at(4).kind == iconfigp::layer_kind::environment);
+  assert(config.layer_at(5).kind == iconfigp::layer_kind::overrides);
+
+  const auto& server = config.root().subsection("server").value();
+  assert(server.unique_key("port").value().value()    == "3");
+  assert(server.unique_key("host").value().value()    == "environment");
+  assert(server.unique_key("threads").value().value() == "4");
+  assert(server.unique_key("timeout").value().value() == "30");
+
+  assert(server.layer_of("port")    == 3);
+  assert(server.layer_of("host")    == 4);
+  assert(server.layer_of("timeout") == 0);
+  assert(!server.layer_of("missing"));
+
+  const auto& client = config.root().subsection("client").value();
+  assert(client.unique_key("retries").value().value() == "7");
+  assert(client.layer_of("retries") == 5);
+  assert(client.unique_key("max-retries").value().value() == " 9 ");
+
+  assert(config.root().subsection("a").value().subsection("b").value()
+      .unique_key("c").value().value() == "nested");
+
+  const auto& paths = config.root().subsection("paths").value();
+  assert(paths.unique_key("windows").value().value() == R"(C:\dir\x)");
+  assert(paths.unique_key("quoted").value().value()  == "'single");
+  assert(paths.unique_key("double").value().value()  == R"("a" b)");
+
+  assert(!config.root().subsection("missing"));
+
+  try {
+    std::ignore = client.require_unique_key("missing");
+    throw std::runtime_error{"expected missing key"};
+  } catch (const iconfigp::missing_key_exception& ex) {
+    auto message = iconfigp::format_exception(ex, config.sources());
+    assert(message.find("<overrides>") != std::string::npos);
+  }
+
+
+
+  iconfigp::layered_config dup;
+  dup.add_string(iconfigp::layer_kind::defaults,  "key = 1\n- key = 2\n", "defaults");
+  dup.add_string(iconfigp::layer_kind::overrides, "other = 1\n",          "overrides");
+
+  try {
+    std::ignore = dup.root().unique_key("key");
+    throw std::runtime_error{"expected multiple definitions"};
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    assert(ex.per_section());
+  }
+
+  dup.add_string(iconfigp::layer_kind::overrides, "key = 3\n", "overrides");
+  assert(dup.root().unique_key("key").value().value() == "3");
+
+
+
+  iconfigp::layered_config partial;
+  partial.add_string(iconfigp::layer_kind::defaults, "a = 1\n", "defaults");
+
+  try {
+    partial.add_string(iconfigp::layer_kind::user, "b = 'unterminated\n", "broken");
+    throw std::runtime_error{"expected a syntax error"};
+  } catch (const iconfigp::syntax_exception& ex) {
+    auto message = iconfigp::format_exception(ex, partial.sources());
+    assert(message.find("broken") != std::string::npos);
+  }
+  assert(partial.layer_count() == 1);
+
+  partial.add_string(iconfigp::layer_kind::overrides, "c = 1; c = 2\n", "overrides");
+  assert(partial.layer_count() == 2);
+  assert(partial.root().unique_key("a").value().value() == "1");
+  assert(!partial.root().unique_key("b"));
+
+  try {
+    std::ignore = partial.root().unique_key("c");
+    throw std::runtime_error{"expected multiple definitions"};
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    auto message = iconfigp::format_exception(ex, partial.sources());
+    assert(message.find("overrides") != std::string::npos);
+    assert(message.find("broken") == std::string::npos);
+  }
+
+  //NOLINTBEGIN(*mt-unsafe)
+  unsetenv("MYAPP__SERVER__HOST");
+  unsetenv("MYAPP__CLIENT__MAX_RETRIES");
+  unsetenv("MYAPP__A__B__C");
+  unsetenv("MYAPP__INVALID____KEY");
+  unsetenv("MYAPP__PATHS__WINDOWS");
+  unsetenv("MYAPP__PATHS__QUOTED");
+  unsetenv("MYAPP__PATHS__DOUBLE");
+  //NOLINTEND(*mt-unsafe)
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,116 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/lazy-document.hpp>
+#include <iconfigp/parser.hpp>
+#include <iconfigp/serialize.hpp>
+
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <cassert>
+
+
+
+static constexpr std::string_view example = R"(
+top = 1
+quoted = "a [quoted] value"; escaped = not\[a section
+
+[panels]
+- anchor= lbr; size=0x22
+
+[wallpaper]
+path= background.png
+@include wallpaper.conf
+
+[panels.left]
+size = 10
+
+[]
+bottom = 2
+
+[wallpaper..ignored]
+color = "#000000"
+
+[panels]
+- anchor = trl
+)";
+
+
+
+namespace {
+  void compare(const iconfigp::section& lhs, const iconfigp::section& rhs) {
+    assert(iconfigp::serialize(lhs) == iconfigp::serialize(rhs));
+    assert(lhs.offset() == rhs.offset());
+    assert(lhs.groups().size() == rhs.groups().size());
+
+    for (size_t i = 0; i < lhs.groups().size(); ++i) {
+      assert(lhs.groups()[i].offset() == rhs.groups()[i].offset());
+    }
+
+    assert(lhs.subsections().size() == rhs.subsections().size());
+    for (size_t i = 0; i < lhs.subsections().size(); ++i) {
+      compare(lhs.subsections()[i], rhs.subsections()[i]);
+    }
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  auto expected = iconfigp::parser::parse(example, 3);
+
+  iconfigp::lazy_document doc{example, 3};
+
+  assert((doc.section_names() == std::vector<std::string_view>{"panels", "wallpaper"}));
+  assert(!doc.materialized("panels"));
+  assert(!doc.materialized("wallpaper"));
+
+  compare(doc.subsection("wallpaper").value(), expected.subsection("wallpaper").value());
+  assert(doc.materialized("wallpaper"));
+  assert(!doc.materialized("panels"));
+
+  compare(doc.subsection("panels").value(), expected.subsection("panels").value());
+  assert(!doc.subsection("left"));
+
+  assert(doc.root().groups().size() == expected.groups().size());
+  assert(doc.root().unique_key("bottom")->value() == "2");
+  assert(doc.root().unique_key("escaped")->value() == "not[a section");
+  assert(doc.root().subsections().empty());
+
+
+
+  iconfigp::lazy_document concurrent{example};
+
+  std::vector<std::future<const iconfigp::section*>> tasks;
+  for (size_t i = 0; i < 8; ++i) {
+    tasks.push_back(std::async(std::launch::async, [&concurrent] {
+      return &concurrent.subsection("panels").value();
+    }));
+  }
+
+  const auto* first = tasks.front().get();
+  for (size_t i = 1; i < tasks.size(); ++i) {
+    assert(tasks[i].get() == first);
+  }
+
+
+
+  iconfigp::lazy_document deferred{"[a]\n= value\n[b]\nkey = value\n"};
+  assert(deferred.subsection("b")->unique_key("key")->value() == "value");
+
+  for (size_t i = 0; i < 2; ++i) {
+    try {
+      std::ignore = deferred.subsection("a");
+      throw std::runtime_error{"expected syntax error"};
+    } catch (const iconfigp::syntax_exception& ex) {
+      assert(ex.type() == iconfigp::syntax_error_type::empty_key);
+    }
+  }
+
+  try {
+    iconfigp::lazy_document invalid{"[a]\nkey = \"unterminated\n[b]\n"};
+    throw std::runtime_error{"expected syntax error"};
+  } catch (const iconfigp::syntax_exception& ex) {
+    assert(ex.type() == iconfigp::syntax_error_type::missing_quotation_mark_eol);
+  }
+}
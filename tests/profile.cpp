@@ -0,0 +1,115 @@
+#include <iconfigp/parser.hpp>
+#include <iconfigp/profile.hpp>
+
+#include <numeric>
+
+#include <cassert>
+
+#if !defined(ICONFIGP_PROFILING)
+#error "this test requires a library built with access profiling"
+#endif
+
+
+
+namespace {
+  [[nodiscard]] uint64_t recorded_lookups() {
+    auto histogram = iconfigp::latency_histogram();
+    return std::accumulate(histogram.begin(), histogram.end(), uint64_t{0});
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  auto root = iconfigp::parser::parse(
+      "a = 1\n"
+      "b = 2\n"
+      "[net]\n"
+      "port = 80\n"
+      "host = localhost\n"
+      "[unused]\n"
+      "key = value\n");
+
+  for (size_t i = 0; i < 3; ++i) {
+    const auto& a = root.unique_key("a").value();
+    if (i > 0) {
+      assert(a.value() == "1");
+    }
+  }
+  assert(root.unique_key("b"));
+
+  std::ignore = root.subsection("net");
+  assert(root.subsection("net").value().unique_key("port").value().value() == "80");
+
+
+
+  assert(root.key_lookup_count() == 4);
+  assert(root.lookup_count() == 0);
+
+  // groups() does not count as a lookup
+  const auto& a = root.groups()[0].entries()[0];
+  assert(a.key() == "a");
+  assert(a.lookup_count() == 3);
+  assert(a.read_count() == 2);
+
+  auto report = iconfigp::access_report(root);
+  assert(report.size() == 5);
+
+  assert(report[0].path.empty() && report[0].key == "a");
+  assert(report[0].lookups == 3 && report[0].reads == 2);
+
+  assert(report[1].path.empty() && report[1].key.empty());
+  assert(report[1].lookups == 0 && report[1].reads == 4);
+
+  assert(report[2].path == "net" && report[2].key.empty());
+  assert(report[2].lookups == 2 && report[2].reads == 1);
+
+  assert(report[3].path == "net" && report[3].key == "port");
+  assert(report[3].lookups == 1 && report[3].reads == 1);
+
+  assert(report[4].key == "b");
+  assert(report[4].lookups == 1 && report[4].reads == 0);
+
+  assert(iconfigp::format_access_report(report) ==
+      "   lookups      reads  key\n"
+      "         3          2  a\n"
+      "         0          4  []\n"
+      "         2          1  [net]\n"
+      "         1          1  net.port\n"
+      "         1          0  b\n");
+
+  auto top = iconfigp::access_report(root, 2);
+  assert(top.size() == 2 && top[0].key == "a" && top[1].key.empty());
+
+
+
+  iconfigp::reset_latency_histogram();
+  std::ignore = root.unique_key("b");
+  assert(recorded_lookups() == 0);
+
+  iconfigp::enable_latency_histogram();
+  std::ignore = root.unique_key("b");
+  std::ignore = root.subsection("net");
+  std::ignore = root.unique_keys("a", "b");
+  assert(recorded_lookups() == 3);
+
+  iconfigp::reset_latency_histogram();
+  assert(recorded_lookups() == 0);
+
+  iconfigp::detail::record_latency(std::chrono::nanoseconds{0});
+  iconfigp::detail::record_latency(std::chrono::nanoseconds{1});
+  iconfigp::detail::record_latency(std::chrono::nanoseconds{1000});
+  iconfigp::detail::record_latency(std::chrono::nanoseconds{1024});
+  iconfigp::detail::record_latency(std::chrono::hours{1});
+
+  auto histogram = iconfigp::latency_histogram();
+  assert(histogram[0] == 2);
+  assert(histogram[9] == 1);
+  assert(histogram[10] == 1);
+  assert(histogram[iconfigp::latency_buckets - 1] == 1);
+  assert(recorded_lookups() == 5);
+
+  iconfigp::enable_latency_histogram(false);
+  std::ignore = root.unique_key("b");
+  assert(recorded_lookups() == 5);
+}
@@ -0,0 +1,123 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/parser.hpp>
+#include <iconfigp/push-parser.hpp>
+#include <iconfigp/serialize.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <cassert>
+
+
+
+static constexpr std::string_view example = R"(
+# leading comment
+poll-rate-ms= 100
+quoted = "a \"quoted\" value; with [brackets]"  ; next = 1
+single = 'single; quoted'
+escaped = line\nbreak\tand\ tab
+@include other.conf
+
+[panels] # a commentary
+- anchor= lbr; size=0x22; margin=0
+-anchor=trl;size=0x0
+
+[e-DP1.panels]
+margin=0:0:0:0
+
+[]
+dither= 0
+# trailing comment)";
+
+
+
+namespace {
+  void compare(const iconfigp::section& lhs, const iconfigp::section& rhs) {
+    assert(lhs.offset() == rhs.offset());
+    assert(lhs.groups().size() == rhs.groups().size());
+
+    for (size_t i = 0; i < lhs.groups().size(); ++i) {
+      auto left  = lhs.groups()[i].entries();
+      auto right = rhs.groups()[i].entries();
+
+      assert(std::ranges::equal(left, right, [](const auto& l, const auto& r) {
+        return l.key_offset() == r.key_offset() && l.value_offset() == r.value_offset();
+      }));
+    }
+
+    assert(lhs.subsections().size() == rhs.subsections().size());
+    for (size_t i = 0; i < lhs.subsections().size(); ++i) {
+      compare(lhs.subsections()[i], rhs.subsections()[i]);
+    }
+  }
+
+
+
+  [[nodiscard]] iconfigp::section push(std::string_view input, size_t chunk) {
+    iconfigp::push_parser parser{7};
+
+    for (size_t i = 0; i < input.size(); i += chunk) {
+      auto part = input.substr(i, chunk);
+      parser.feed(std::span{part.data(), part.size()});
+    }
+
+    return parser.finish();
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  auto expected = iconfigp::parser::parse(example, 7);
+
+  for (size_t chunk = 1; chunk <= example.size(); ++chunk) {
+    auto result = push(example, chunk);
+
+    assert(iconfigp::serialize(result) == iconfigp::serialize(expected));
+    compare(result, expected);
+  }
+
+
+
+  std::string large;
+  for (size_t i = 0; i < 10000; ++i) {
+    large += "- id = " + std::to_string(i) + "; name = \"group " + std::to_string(i) + "\"\n";
+  }
+
+  iconfigp::push_parser streaming;
+  size_t max_buffered{0};
+  for (size_t i = 0; i < large.size(); i += 16) {
+    auto part = std::string_view{large}.substr(i, 16);
+    streaming.feed(std::span{part.data(), part.size()});
+    max_buffered = std::max(max_buffered, streaming.buffered());
+  }
+
+  // never more than the longest line plus one chunk
+  assert(max_buffered < 64);
+
+  auto root = streaming.finish();
+  assert(root.groups().size() == iconfigp::parser::parse(large).groups().size());
+  assert(root.groups().back().entries().front().value() == "9999");
+
+
+
+  try {
+    iconfigp::push_parser incomplete;
+    std::string_view input{"[a]\nkey = \"unterminated"};
+    incomplete.feed(std::span{input.data(), input.size()});
+    std::ignore = incomplete.finish();
+    throw std::runtime_error{"expected syntax error"};
+  } catch (const iconfigp::syntax_exception& ex) {
+    assert(ex.type() == iconfigp::syntax_error_type::missing_quotation_mark);
+  }
+
+  try {
+    iconfigp::push_parser invalid;
+    std::string_view input{"key = \"value\" trailing\nother = 1\n"};
+    invalid.feed(std::span{input.data(), input.size()});
+    throw std::runtime_error{"expected syntax error"};
+  } catch (const iconfigp::syntax_exception& ex) {
+    assert(ex.type() == iconfigp::syntax_error_type::unexpected_character);
+  }
+}
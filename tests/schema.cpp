@@ -0,0 +1,165 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/format.hpp>
+#include <iconfigp/parser.hpp>
+#include <iconfigp/schema.hpp>
+
+#include <stdexcept>
+
+#include <cassert>
+
+
+
+static constexpr std::string_view description = R"(
+- key = poll-rate-ms; type = u32; default = 100
+- key = name; count = 1
+- key = verbose; type = bool; count = ?
+
+[panels]
+- key = anchor; count = +
+- key = size;   type = u16
+
+[wallpaper]
+- key = path
+- key = scale; default = zoom
+)";
+
+
+
+static constexpr std::string_view config = R"(
+name = main
+verbose = maybe
+unknown = 1
+
+[panels]
+anchor = top
+anchor = bottom
+size = 100000
+
+[theme]
+color = red
+)";
+
+
+
+namespace {
+  template<typename Exception>
+  [[nodiscard]] size_t count_errors(const iconfigp::validation_report& report) {
+    size_t count{0};
+    for (const auto& error: report.errors) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const Exception& ex) {
+        assert(!iconfigp::format_exception(ex, config).empty());
+        count++;
+      } catch (...) {
+      }
+    }
+    return count;
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  iconfigp::schema schema{iconfigp::parser::parse(description)};
+
+  auto root   = iconfigp::parser::parse(config);
+  auto report = schema.validate(root);
+
+  assert(!report.ok());
+  assert(report.errors.size() == 4);
+  assert(count_errors<iconfigp::value_parse_exception>(report)     == 2);
+  assert(count_errors<iconfigp::unknown_key_exception>(report)     == 1);
+  assert(count_errors<iconfigp::unknown_section_exception>(report) == 1);
+
+  assert(report.defaults == 2);
+  assert(root.unique_key("poll-rate-ms")->value() == "100");
+  assert(root.subsection("wallpaper")->unique_key("scale")->value() == "zoom");
+  assert(!root.subsection("wallpaper")->unique_key("path"));
+
+
+
+  auto valid = iconfigp::parser::parse("name = a; poll-rate-ms = 5\n[panels]\nanchor = top");
+  auto valid_report = schema.validate(valid);
+  assert(valid_report.ok());
+  assert(valid_report.defaults == 1);
+  assert(valid.unique_key("poll-rate-ms")->value() == "5");
+
+
+
+  auto incomplete = iconfigp::parser::parse("name = a; name = b\n");
+  auto incomplete_report = schema.validate(incomplete);
+  assert(count_errors<iconfigp::multiple_definitions_exception>(incomplete_report) == 1);
+  assert(count_errors<iconfigp::missing_key_exception>(incomplete_report)          == 1);
+
+  // keys of missing sections are reported by their path
+  for (const auto& error: incomplete_report.errors) {
+    try {
+      std::rethrow_exception(error);
+    } catch (const iconfigp::missing_key_exception& ex) {
+      assert(ex.key() == "panels.anchor");
+    } catch (const iconfigp::exception&) {}
+  }
+
+
+
+  try {
+    iconfigp::schema invalid{iconfigp::parser::parse("- key = a; type = color")};
+    throw std::runtime_error{"expected unknown type"};
+  } catch (const iconfigp::value_parse_exception& ex) {
+    assert(ex.target() == "type");
+  }
+
+  try {
+    iconfigp::schema invalid{iconfigp::parser::parse("- key = a; count = 2")};
+    throw std::runtime_error{"expected invalid count"};
+  } catch (const iconfigp::value_parse_exception& ex) {
+    assert(ex.target() == "count");
+  }
+
+  try {
+    iconfigp::schema invalid{iconfigp::parser::parse("- key = a; type = u8; default = 300")};
+    throw std::runtime_error{"expected invalid default"};
+  } catch (const iconfigp::value_parse_exception& ex) {
+    assert(ex.target() == "u8");
+    assert(ex.value().value() == "300");
+  }
+
+  try {
+    iconfigp::schema invalid{iconfigp::parser::parse("- key = a; count = many")};
+    throw std::runtime_error{"expected invalid count"};
+  } catch (const iconfigp::value_parse_exception& ex) {
+    assert(ex.target() == "count" && ex.value().value() == "many");
+  }
+
+
+
+  // defaults are appended after a value error was recorded for the same group
+  iconfigp::schema appending{iconfigp::parser::parse(
+      "- key = a; type = i32\n- key = b; type = i32; default = 3")};
+  std::string_view bad_value{"a = x"};
+  auto appended = iconfigp::parser::parse(bad_value);
+  auto appended_report = appending.validate(appended);
+  assert(appended_report.defaults == 1);
+  assert(count_errors<iconfigp::value_parse_exception>(appended_report) == 1);
+  assert(iconfigp::format_report(appended_report, bad_value).starts_with(
+        "The value x cannot be parsed as i32"));
+
+
+
+  // defaults of a section which starts with a row do not end up in the first row
+  iconfigp::schema rows{iconfigp::parser::parse(
+      "[items]\n- key = name; count = *\n- key = scale; type = f32; default = 1")};
+  auto table = iconfigp::parser::parse("[items]\n- name = a\n- name = b\n");
+  auto rows_report = rows.validate(table);
+  assert(rows_report.ok() && rows_report.defaults == 1);
+
+  const auto& items = table.subsection("items").value();
+  assert(items.groups().size() == 3);
+  assert(items.groups()[0].entries().size() == 1);
+  assert(items.groups()[1].entries().size() == 1);
+  assert(items.groups()[2].entries().size() == 1);
+  assert(items.find_groups("name", "a").front() == 1);
+  assert(items.find_groups("scale", "1").front() == 0);
+  assert(items.unique_key("scale").value().value() == "1");
+}
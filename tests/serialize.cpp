@@ -56,6 +56,9 @@ int main() { // NOLINT(*exception-escape)
   test("\" foo \"",     " foo "sv);
 
   test(R"("fo\"o")",    R"(fo"o)"sv);
+  test(R"("C:\\dir")",  R"(C:\dir)"sv);
+  test(R"("'foo")",     "'foo"sv);
+  test("fo'o",          "fo'o"sv);
 
 
 
@@ -0,0 +1,106 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/parser.hpp>
+#include <iconfigp/stream.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include <cassert>
+
+
+
+static constexpr std::string_view example = R"(
+top = 1
+
+[records]
+- id = 1; name = "first"
+- id = 2; name = second
+
+[other]
+key = value
+- key = value2
+
+[records.nested]
+id = 3
+
+[records..ignored]
+id = 4
+-
+- id = 5
+
+[]
+bottom = 2
+)";
+
+
+
+namespace {
+  void compare(const std::vector<std::string>& path) {
+    auto root = iconfigp::parser::parse(example);
+
+    const iconfigp::section* sec = &root;
+    for (const auto& name: path) {
+      sec = &sec->subsection(name).value();
+    }
+
+    std::vector<const iconfigp::group*> expected;
+    for (const auto& grp: sec->groups()) {
+      if (!grp.empty()) {
+        expected.push_back(&grp);
+      }
+    }
+
+    size_t index{0};
+    for (const auto& grp: iconfigp::stream_groups(example, path)) {
+      assert(index < expected.size());
+      assert(grp.offset == expected[index]->offset());
+
+      auto entries = expected[index]->entries();
+      assert(std::ranges::equal(grp.entries, entries, [](const auto& lhs, const auto& rhs) {
+        return lhs.key() == rhs.key() && lhs.value() == rhs.value()
+          && lhs.key_offset() == rhs.key_offset();
+      }));
+
+      index++;
+    }
+    assert(index == expected.size());
+  }
+}
+
+
+
+int main() { // NOLINT(*exception-escape)
+  compare({});
+  compare({"records"});
+  compare({"other"});
+  compare({"records", "nested"});
+
+  size_t events{0};
+  for (const auto& event: iconfigp::parser::events(example)) {
+    std::ignore = event;
+    events++;
+  }
+  assert(events == 21);
+
+  std::string large;
+  for (size_t i = 0; i < 100000; ++i) {
+    large += "- id = " + std::to_string(i) + "\n";
+  }
+
+  size_t count{0};
+  for (const auto& grp: iconfigp::stream_groups(large, {})) {
+    assert(grp.entries.size() == 1);
+    assert(grp.entries.front().value() == std::to_string(count));
+    count++;
+  }
+  assert(count == 100000);
+
+  try {
+    for (const auto& grp: iconfigp::stream_groups("[a]\nkey = \"unterminated\n", {"a"})) {
+      std::ignore = grp;
+    }
+    throw std::runtime_error{"expected syntax error"};
+  } catch (const iconfigp::syntax_exception& ex) {
+    assert(ex.type() == iconfigp::syntax_error_type::missing_quotation_mark_eol);
+  }
+}
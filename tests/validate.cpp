@@ -0,0 +1,141 @@
+#include <iconfigp/exception.hpp>
+#include <iconfigp/format.hpp>
+#include <iconfigp/parser.hpp>
+#include <iconfigp/validate.hpp>
+
+#include <string>
+#include <vector>
+
+#include <cassert>
+
+
+
+int main() { // NOLINT(*exception-escape)
+  std::string_view input{R"(
+rate = fast
+name = test
+name = again
+
+[output]
+width = 800
+- height = 600; height = 400
+
+[panel]
+size = 20
+- size = 30
+)"};
+
+  auto root = iconfigp::parser::parse(input);
+
+  std::vector expectations{
+    iconfigp::expect<int>("rate"),
+    iconfigp::expect<std::string_view>("name"),
+    iconfigp::expect<int>("output.width"),
+    iconfigp::expect<int>("output.height"),
+    iconfigp::expect<int>("panel.size"),
+    iconfigp::expect<bool>("output.fullscreen"),
+    iconfigp::expect<bool>("output.vsync", false),
+    iconfigp::expect<int>("missing.key"),
+  };
+
+  auto report = iconfigp::validate_all(root, expectations);
+  assert(!report.ok());
+  assert(report.errors.size() == 6);
+
+  try {
+    std::rethrow_exception(report.errors[0]);
+  } catch (const iconfigp::value_parse_exception& ex) {
+    assert(ex.value().value() == "fast" && ex.target() == "i32");
+  }
+
+  try {
+    std::rethrow_exception(report.errors[1]);
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    assert(!ex.per_section() && ex.definition2().value() == "again");
+  }
+
+  try {
+    std::rethrow_exception(report.errors[2]);
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    assert(!ex.per_section() && ex.definition1().value() == "600");
+  }
+
+  try {
+    std::rethrow_exception(report.errors[3]);
+  } catch (const iconfigp::multiple_definitions_exception& ex) {
+    assert(ex.per_section() && ex.definition2().value() == "30");
+  }
+
+  try {
+    std::rethrow_exception(report.errors[4]);
+  } catch (const iconfigp::missing_key_exception& ex) {
+    assert(ex.key() == "fullscreen");
+    assert(ex.offset() == root.subsection("output")->offset());
+  }
+
+  try {
+    std::rethrow_exception(report.errors[5]);
+  } catch (const iconfigp::missing_key_exception& ex) {
+    assert(ex.key() == "key" && ex.offset() == root.offset());
+  }
+
+  assert(root.subsection("output")->unique_key("width")->used());
+
+
+
+  auto format_each = [](const iconfigp::validation_report& rep, std::string_view source) {
+    std::string output;
+    for (const auto& error: rep.errors) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const iconfigp::exception& ex) {
+        if (!output.empty()) {
+          output += '\n';
+        }
+        output += iconfigp::format_exception(ex, source);
+      }
+    }
+    return output;
+  };
+
+  assert(iconfigp::format_report(report, input) == format_each(report, input));
+  assert(iconfigp::format_report(iconfigp::validation_report{}, input).empty());
+
+
+
+  std::string large;
+  std::vector<iconfigp::key_expectation> many;
+  for (size_t i = 0; i < 2000; ++i) {
+    auto key = "key" + std::to_string(i);
+    large += key + " = " + (i % 100 == 0 ? "x" : std::to_string(i)) + '\n';
+    many.push_back(iconfigp::expect<int>(key));
+    many.push_back(iconfigp::expect<int>(key, false));
+  }
+
+  auto large_root = iconfigp::parser::parse(large);
+  auto sequential = iconfigp::validate_all(large_root, many);
+  auto parallel   = iconfigp::validate_all(large_root, many, true);
+
+  assert(sequential.errors.size() == 40);
+  assert(iconfigp::format_report(sequential, large) == format_each(sequential, large));
+  assert(iconfigp::format_report(sequential, large) == iconfigp::format_report(parallel, large));
+
+
+
+  auto duplicated = iconfigp::parser::parse(input);
+
+  auto per_group = iconfigp::audit_duplicates(duplicated);
+  assert(per_group.size() == 2);
+  assert(per_group[0].definition1().key() == "name" && !per_group[0].per_section());
+  assert(per_group[0].definition1().key_offset() < per_group[0].definition2().key_offset());
+  assert(per_group[1].definition2().value() == "400");
+  assert(iconfigp::format_exception(per_group[1], input).starts_with(
+        "The key height is only allowed once per group"));
+
+  auto all = iconfigp::audit_duplicates(duplicated, true);
+  assert(all.size() == 3);
+  assert(all[2].per_section() && all[2].definition1().value() == "20");
+
+  assert(!duplicated.used());
+  assert(iconfigp::audit_duplicates(large_root).empty());
+}
@@ -5,6 +5,7 @@
 #include <iconfigp/path.hpp>
 #include <iconfigp/value-parser.hpp>
 
+#include <cassert>
 #include <iostream>
 #include <span>
 #include <sstream>
@@ -52,6 +53,7 @@ namespace {
     } catch (iconfigp::value_parse_exception& ex) {
       if (correct) {
         std::cout << input << '\n' << std::flush;
+        ex.detach();
         throw;
       }
     }
@@ -81,6 +83,11 @@ namespace {
     bar
   };
 
+  struct vec2 {
+    float x;
+    float y;
+  };
+
   std::ostream& operator<<(std::ostream& out, my_enum me) {
     return out << static_cast<int>(me);
   }
@@ -94,6 +101,29 @@ ICONFIGP_DEFINE_ENUM_LUT(my_enum,
 
 
 
+template<> struct iconfigp::value_parser<vec2> {
+  static constexpr std::string_view name{"vec2"};
+
+  static std::string format() { return "x:y"; }
+
+  static iconfigp::expected<vec2, iconfigp::range_error> try_parse(std::string_view input) {
+    auto result = iconfigp::try_parse_as_array<float, 2>(input);
+    if (!result) {
+      return iconfigp::unexpected{std::move(result).error()};
+    }
+    return vec2{(*result)[0], (*result)[1]};
+  }
+
+  static std::optional<vec2> parse(std::string_view input) {
+    if (auto result = try_parse(input)) {
+      return *result;
+    }
+    return {};
+  }
+};
+
+
+
 int main() { // NOLINT(*exception-escape)
   parse_value<std::string_view>("hello world", "hello world");
 
@@ -186,6 +216,29 @@ int main() { // NOLINT(*exception-escape)
 
   parse_value<std::filesystem::path>("/root", "/root");
 
+  {
+    auto root = std::filesystem::temp_directory_path() / "iconfigp-path-test";
+    std::filesystem::create_directories(root / "assets");
+
+    std::vector<std::string_view> inputs{"assets", "missing", "/abs", "~/file", "~"};
+    for (size_t i = 0; i < 1000; ++i) {
+      inputs.emplace_back(i % 2 == 0 ? "assets" : "missing");
+    }
+
+    iconfigp::path_resolver resolver{root};
+    for (bool parallel: {false, true}) {
+      auto resolved = resolver.resolve(inputs, parallel);
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        if (resolved[i] != iconfigp::resolve_path(inputs[i], root)) {
+          std::cout << inputs[i] << " was resolved as " << resolved[i] << std::endl;
+          throw std::runtime_error{"incorrectly resolved"};
+        }
+      }
+    }
+
+    std::filesystem::remove_all(root);
+  }
+
   parse_array<4>("1.0",                 {1.F, 1.F, 1.F, 1.F});
   parse_array<4>("1.0,0.0",             {});
   parse_array<4>("0.0,0.0,1.0,0.0",     {0.F, 0.F, 1.F, 0.F});
@@ -194,5 +247,81 @@ int main() { // NOLINT(*exception-escape)
   parse_array<4>(",0.0,0.0,1.0",        {});
 
 
+
+  {
+    std::optional<iconfigp::value_parse_exception> copy;
+
+    {
+      iconfigp::key_value kv{iconfigp::located_string{"rate"},
+                             iconfigp::located_string{"fast"}};
+      try {
+        std::ignore = iconfigp::parse<int32_t>(kv);
+      } catch (iconfigp::value_parse_exception& ex) {
+        assert(&ex.value() == &kv);
+        assert(std::string_view{ex.what()} == "cannot parse value of rate as i32");
+
+        ex.detach();
+        assert(&ex.value() != &kv);
+        copy = ex;
+      }
+    }
+
+    assert(copy->value().value() == "fast");
+    assert(copy->target() == "i32");
+    assert(copy->format().starts_with("integer from"));
+    assert(std::string_view{copy->what()} == "cannot parse value of rate as i32");
+
+    iconfigp::key_value kv{iconfigp::located_string{"rate"},
+                           iconfigp::located_string{"slow"}};
+    auto borrowed = iconfigp::value_parse_exception::borrowing(kv, "i32", "integer");
+    assert(&borrowed.value() == &kv);
+    assert(std::string_view{borrowed.what()} == "cannot parse value of rate as i32");
+
+    borrowed.detach();
+    assert(&borrowed.value() != &kv && borrowed.value().value() == "slow");
+  }
+
+
+
+  {
+    iconfigp::key_value rate{iconfigp::located_string{"rate"}, iconfigp::located_string{"25"}};
+    auto parsed = iconfigp::try_parse<int32_t>(rate);
+    assert(parsed && *parsed == 25);
+    assert(rate.used());
+
+    iconfigp::key_value fast{iconfigp::located_string{"rate"}, iconfigp::located_string{"fast"}};
+    auto failed = iconfigp::try_parse<int32_t>(fast);
+    assert(!failed);
+    assert(failed.error().value == &fast);
+    assert(failed.error().target == "i32");
+    assert(!failed.error().range);
+    assert(std::string_view{failed.error().to_exception().what()}
+        == "cannot parse value of rate as i32");
+
+    auto missing = iconfigp::try_parse<int32_t>(iconfigp::opt_ref<const iconfigp::key_value>{});
+    assert(missing && !missing->has_value());
+    assert(!iconfigp::try_parse<int32_t>(iconfigp::opt_ref<const iconfigp::key_value>{fast}));
+
+    iconfigp::key_value pos{iconfigp::located_string{"pos"}, iconfigp::located_string{"1:x"}};
+    static_assert(iconfigp::value_parser_reports_range<vec2>);
+    auto vec = iconfigp::try_parse<vec2>(pos);
+    assert(!vec && vec.error().range);
+    assert(vec.error().range->message == "unable to parse item");
+    assert(vec.error().range->offset == 2 && vec.error().range->size == 1);
+
+    try {
+      std::ignore = iconfigp::parse<vec2>(pos);
+      assert(false);
+    } catch (const iconfigp::value_parse_exception& ex) {
+      assert(ex.range_ex() && ex.range_ex()->offset() == 2);
+    }
+
+    auto array = iconfigp::try_parse_as_array<float, 3>("1,2");
+    assert(!array && array.error().message == "expected more items");
+    auto full = iconfigp::try_parse_as_array<float, 3>("1,2,3");
+    assert(full && (*full)[2] == 3.F);
+  }
+
+
   // NOLINTEND(*-magic-numbers)
 }
@@ -0,0 +1,573 @@
+// Copyright (c) 2023 wolmibo
+// SPDX-License-Identifier: MIT
+
+// Generates a header with a struct and a parse function for a schema (see doc/format.md):
+//   iconfigp-codegen <schema> <header> <name> [namespace]
+
+#include <iconfigp/exception.hpp>
+#include <iconfigp/format.hpp>
+#include <iconfigp/key.hpp>
+#include <iconfigp/parser.hpp>
+#include <iconfigp/schema.hpp>
+#include <iconfigp/section.hpp>
+#include <iconfigp/value-parser.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <concepts>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <set>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+
+namespace {
+  [[nodiscard]] std::string string_literal(std::string_view value) {
+    std::string output{'"'};
+
+    for (char c: value) {
+      switch (c) {
+        case '"':  output += "\\\""; break;
+        case '\\': output += "\\\\"; break;
+        case '\n': output += "\\n";  break;
+        case '\t': output += "\\t";  break;
+        case '\r': output += "\\r";  break;
+        default:   output.push_back(c);
+      }
+    }
+
+    output.push_back('"');
+    return output;
+  }
+
+
+
+  template<std::floating_point T>
+  [[nodiscard]] std::string float_literal(T value) {
+    std::string_view type;
+    std::string_view suffix;
+    if constexpr (std::is_same_v<T, float>) {
+      type   = "float";
+      suffix = "F";
+    } else if constexpr (std::is_same_v<T, double>) {
+      type   = "double";
+    } else {
+      type   = "long double";
+      suffix = "L";
+    }
+
+    std::string_view sign = std::signbit(value) ? "-" : "";
+
+    // inf and nan are no literals
+    if (std::isinf(value)) {
+      return iconfigp::format("{}std::numeric_limits<{}>::infinity()", sign, type);
+    }
+    if (std::isnan(value)) {
+      return iconfigp::format("{}std::numeric_limits<{}>::quiet_NaN()", sign, type);
+    }
+
+    auto literal = iconfigp::format("{}", value);
+    if (literal.find_first_of(".e") == std::string::npos) {
+      literal += ".0";
+    }
+    return literal.append(suffix);
+  }
+
+
+
+  template<typename T>
+  [[nodiscard]] std::string number_literal(std::string_view value) {
+    // the default value has already been checked by iconfigp::schema
+    auto parsed = iconfigp::value_parser<T>::parse(value).value();
+
+    if constexpr (std::is_floating_point_v<T>) {
+      return float_literal(parsed);
+    } else if constexpr (std::is_signed_v<T>) {
+      if (static_cast<int64_t>(parsed) == std::numeric_limits<int64_t>::min()) {
+        // 9223372036854775808 does not fit into any signed literal
+        return iconfigp::format("({} - 1)", std::numeric_limits<int64_t>::min() + 1);
+      }
+      return iconfigp::format("{}", static_cast<int64_t>(parsed));
+    } else {
+      return iconfigp::format("{}U", static_cast<uint64_t>(parsed));
+    }
+  }
+
+  [[nodiscard]] std::string bool_literal(std::string_view value) {
+    return iconfigp::value_parser<bool>::parse(value).value() ? "true" : "false";
+  }
+
+
+
+  struct type_mapping {
+    std::string_view name;
+    std::string_view parse_type;
+    std::string_view field_type;
+    std::string    (*literal)(std::string_view);
+  };
+
+  constexpr std::array type_mappings{
+    type_mapping{"string", "std::string_view", "std::string", &string_literal},
+    type_mapping{"bool",   "bool",             "bool",        &bool_literal},
+    type_mapping{"i8",     "int8_t",           "int8_t",      &number_literal<int8_t>},
+    type_mapping{"u8",     "uint8_t",          "uint8_t",     &number_literal<uint8_t>},
+    type_mapping{"i16",    "int16_t",          "int16_t",     &number_literal<int16_t>},
+    type_mapping{"u16",    "uint16_t",         "uint16_t",    &number_literal<uint16_t>},
+    type_mapping{"i32",    "int32_t",          "int32_t",     &number_literal<int32_t>},
+    type_mapping{"u32",    "uint32_t",         "uint32_t",    &number_literal<uint32_t>},
+    type_mapping{"i64",    "int64_t",          "int64_t",     &number_literal<int64_t>},
+    type_mapping{"u64",    "uint64_t",         "uint64_t",    &number_literal<uint64_t>},
+    type_mapping{"f32",    "float",            "float",       &number_literal<float>},
+    type_mapping{"f64",    "double",           "double",      &number_literal<double>},
+    type_mapping{"f128",   "long double",      "long double", &number_literal<long double>},
+  };
+
+
+
+
+
+  constexpr std::array keywords{
+    "alignas", "alignof", "and", "asm", "auto", "bool", "break", "case", "catch", "char",
+    "class", "concept", "const", "consteval", "constexpr", "constinit", "continue",
+    "decltype", "default", "delete", "do", "double", "else", "enum", "explicit",
+    "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int",
+    "long", "mutable", "namespace", "new", "noexcept", "not", "nullptr", "operator", "or",
+    "private", "protected", "public", "register", "requires", "return", "short",
+    "signed", "sizeof", "static", "struct", "switch", "template", "this", "throw",
+    "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+    "virtual", "void", "volatile", "while", "xor",
+  };
+
+  [[nodiscard]] std::string identifier(std::string_view name) {
+    std::string output;
+
+    for (char c: name) {
+      output.push_back(std::isalnum(static_cast<unsigned char>(c)) != 0 ? c : '_');
+    }
+
+    if (output.empty() || std::isdigit(static_cast<unsigned char>(output.front())) != 0) {
+      output.insert(0, "_");
+    }
+
+    if (std::ranges::find(keywords, output) != keywords.end()) {
+      output.push_back('_');
+    }
+
+    return output;
+  }
+
+
+
+
+
+  struct field {
+    std::string                 key;
+    std::string                 name;
+    const type_mapping*         type;
+    iconfigp::cardinality       count;
+    std::optional<std::string>  fallback;
+
+    [[nodiscard]] bool repeated() const {
+      return count == iconfigp::cardinality::any ||
+        count == iconfigp::cardinality::at_least_one;
+    }
+
+    [[nodiscard]] bool required() const {
+      return count == iconfigp::cardinality::one ||
+        count == iconfigp::cardinality::at_least_one;
+    }
+
+    [[nodiscard]] bool tracked() const {
+      return count != iconfigp::cardinality::any;
+    }
+  };
+
+  struct section_type {
+    std::string               key;
+    std::string               name;      // member in the parent
+    std::string               type_name; // qualified
+    std::vector<field>        fields;
+    std::vector<section_type> sections;
+  };
+
+
+
+  void check_unique(std::set<std::string>& names, const std::string& name) {
+    if (!names.insert(name).second) {
+      throw std::runtime_error{iconfigp::format("identifier {} is used twice", name)};
+    }
+  }
+
+  void check_hashes(std::set<uint64_t>& hashes, std::string_view key) {
+    if (!hashes.insert(iconfigp::key_hash(key)).second) {
+      throw std::runtime_error{iconfigp::format("hash collision for key {}", key)};
+    }
+  }
+
+
+
+  [[nodiscard]] section_type collect(
+      const iconfigp::section& description,
+      std::string              key,
+      std::string              type_name
+  ) {
+    section_type output{
+      .key       = key,
+      .name      = identifier(key),
+      .type_name = std::move(type_name),
+      .fields    = {},
+      .sections  = {}
+    };
+
+    std::set<std::string> names;
+    std::set<uint64_t>    hashes;
+
+    for (const auto& grp: description.groups()) {
+      if (grp.empty()) {
+        continue;
+      }
+
+      auto [name, type, count, fallback] = grp.unique_keys("key", "type", "count", "default");
+
+      auto type_name = type ? type->value() : "string";
+      const auto* mapping = std::ranges::find_if(type_mappings,
+          [type_name](const auto& m) { return m.name == type_name; });
+
+      if (mapping == type_mappings.end()) {
+        throw std::runtime_error{iconfigp::format("type {} cannot be generated", type_name)};
+      }
+
+      field f{
+        .key      = std::string{name->value()},
+        .name     = identifier(name->value()),
+        .type     = mapping,
+        .count    = iconfigp::parse<iconfigp::cardinality>(count)
+                      .value_or(iconfigp::cardinality::optional),
+        .fallback = {}
+      };
+
+      if (fallback) {
+        f.fallback = std::string{fallback->value()};
+      }
+
+      check_unique(names, f.name);
+      check_hashes(hashes, f.key);
+      output.fields.push_back(std::move(f));
+    }
+
+    std::set<uint64_t> section_hashes;
+
+    for (const auto& subsec: description.subsections()) {
+      auto sub = collect(subsec, std::string{subsec.name()},
+          output.type_name + "::" + identifier(subsec.name()) + "_section");
+
+      check_unique(names, sub.name);
+      check_unique(names, sub.name + "_section");
+      check_hashes(section_hashes, sub.key);
+      output.sections.push_back(std::move(sub));
+    }
+
+    return output;
+  }
+
+
+
+  // key reported as missing if the section is not present at all, by its path from the
+  // parent like iconfigp::schema reports it
+  [[nodiscard]] std::optional<std::string> first_required(const section_type& sec) {
+    for (const auto& f: sec.fields) {
+      if (f.required()) {
+        return sec.key + '.' + f.key;
+      }
+    }
+
+    for (const auto& sub: sec.sections) {
+      if (auto key = first_required(sub)) {
+        return sec.key + '.' + *key;
+      }
+    }
+
+    return {};
+  }
+
+
+
+
+
+  void write_struct(std::ostream& out, const section_type& sec, const std::string& indent) {
+    for (const auto& sub: sec.sections) {
+      out << indent << "struct " << sub.name << "_section {\n";
+      write_struct(out, sub, indent + "  ");
+      out << indent << "};\n\n";
+    }
+
+    for (const auto& f: sec.fields) {
+      out << indent;
+
+      if (f.repeated()) {
+        out << "std::vector<" << f.type->field_type << "> " << f.name;
+      } else if (f.required() || f.fallback) {
+        out << f.type->field_type << ' ' << f.name;
+      } else {
+        out << "std::optional<" << f.type->field_type << "> " << f.name;
+      }
+
+      if (f.fallback && !f.repeated()) {
+        out << " = " << f.type->literal(*f.fallback);
+      } else if (f.fallback) {
+        out << "{" << f.type->literal(*f.fallback) << "}";
+      } else {
+        out << "{}";
+      }
+
+      out << ";\n";
+    }
+
+    for (const auto& sub: sec.sections) {
+      out << indent << sub.name << "_section " << sub.name << ";\n";
+    }
+  }
+
+
+
+  void write_parse(std::ostream& out, const section_type& sec) {
+    for (const auto& sub: sec.sections) {
+      write_parse(out, sub);
+    }
+
+    out << "  inline void parse_section(const iconfigp::section& sec, "
+        << sec.type_name << "& output) {\n";
+
+    for (size_t i = 0; i < sec.fields.size(); ++i) {
+      if (sec.fields[i].tracked()) {
+        out << "    const iconfigp::key_value* seen_" << i << "{nullptr};\n";
+      }
+    }
+
+    for (const auto& f: sec.fields) {
+      if (f.repeated() && f.fallback) {
+        out << "    bool defaulted_" << f.name << "{true};\n";
+      }
+    }
+
+    out << "\n    for (const auto& grp: sec.groups()) {\n"
+        << "      for (const auto& kv: grp.entries()) {\n";
+
+    if (!sec.fields.empty()) {
+      out << "        switch (iconfigp::key_hash(kv.key())) {\n";
+
+      for (size_t i = 0; i < sec.fields.size(); ++i) {
+        const auto& f = sec.fields[i];
+        auto key = string_literal(f.key);
+        auto value = iconfigp::format("iconfigp::parse<{}>(kv)", f.type->parse_type);
+        if (f.type->field_type != f.type->parse_type) {
+          value = iconfigp::format("{}{{{}}}", f.type->field_type, value);
+        }
+
+        out << "          case iconfigp::key_hash(" << key << "):\n"
+            << "            if (kv.key() == " << key << ") {\n";
+
+        if (f.tracked() && !f.repeated()) {
+          out << "              if (seen_" << i << " != nullptr) {\n"
+              << "                throw iconfigp::multiple_definitions_exception{*seen_"
+              << i << ", kv, true};\n"
+              << "              }\n";
+        }
+        if (f.tracked()) {
+          out << "              seen_" << i << " = &kv;\n";
+        }
+
+        if (f.repeated()) {
+          if (f.fallback) {
+            out << "              if (defaulted_" << f.name << ") {\n"
+                << "                output." << f.name << ".clear();\n"
+                << "                defaulted_" << f.name << " = false;\n"
+                << "              }\n";
+          }
+          out << "              output." << f.name << ".push_back(" << value << ");\n";
+        } else {
+          out << "              output." << f.name << " = " << value << ";\n";
+        }
+
+        out << "              continue;\n"
+            << "            }\n"
+            << "            break;\n";
+      }
+
+      out << "        }\n";
+    }
+
+    out << "        throw iconfigp::unknown_key_exception{kv};\n"
+        << "      }\n"
+        << "    }\n";
+
+    for (size_t i = 0; i < sec.fields.size(); ++i) {
+      const auto& f = sec.fields[i];
+      if (f.required()) {
+        out << "\n    if (seen_" << i << " == nullptr) {\n"
+            << "      throw iconfigp::missing_key_exception{" << string_literal(f.key)
+            << ", sec.offset()};\n"
+            << "    }\n";
+      }
+    }
+
+    out << '\n';
+    for (size_t i = 0; i < sec.sections.size(); ++i) {
+      out << "    bool present_" << i << "{false};\n";
+    }
+
+    out << "    for (const auto& subsec: sec.subsections()) {\n";
+
+    if (!sec.sections.empty()) {
+      out << "      switch (iconfigp::key_hash(subsec.name())) {\n";
+
+      for (size_t i = 0; i < sec.sections.size(); ++i) {
+        const auto& sub = sec.sections[i];
+        auto key = string_literal(sub.key);
+
+        out << "        case iconfigp::key_hash(" << key << "):\n"
+            << "          if (subsec.name() == " << key << ") {\n"
+            << "            parse_section(subsec, output." << sub.name << ");\n"
+            << "            present_" << i << " = true;\n"
+            << "            continue;\n"
+            << "          }\n"
+            << "          break;\n";
+      }
+
+      out << "      }\n";
+    }
+
+    out << "      throw iconfigp::unknown_section_exception{std::string{subsec.name()}, "
+           "subsec.offset()};\n"
+        << "    }\n";
+
+    for (size_t i = 0; i < sec.sections.size(); ++i) {
+      if (auto key = first_required(sec.sections[i])) {
+        out << "\n    if (!present_" << i << ") {\n"
+            << "      throw iconfigp::missing_key_exception{" << string_literal(*key)
+            << ", sec.offset()};\n"
+            << "    }\n";
+      }
+    }
+
+    out << "  }\n\n\n\n";
+  }
+
+
+
+  void write_header(
+      std::ostream&      out,
+      const section_type& root,
+      std::string_view   source,
+      const std::string& name,
+      std::string_view   name_space
+  ) {
+    auto guard = identifier(name);
+    std::ranges::transform(guard, guard.begin(),
+        [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+
+    out << "// generated by iconfigp-codegen from " << source << ", do not edit\n\n"
+        << "#ifndef ICONFIGP_GENERATED_" << guard << "_HPP_INCLUDED\n"
+        << "#define ICONFIGP_GENERATED_" << guard << "_HPP_INCLUDED\n\n"
+        << "#include <iconfigp/exception.hpp>\n"
+        << "#include <iconfigp/key.hpp>\n"
+        << "#include <iconfigp/section.hpp>\n"
+        << "#include <iconfigp/value-parser.hpp>\n\n"
+        << "#include <cstdint>\n"
+        << "#include <limits>\n"
+        << "#include <optional>\n"
+        << "#include <string>\n"
+        << "#include <string_view>\n"
+        << "#include <vector>\n\n\n\n";
+
+    if (!name_space.empty()) {
+      out << "namespace " << name_space << " {\n\n";
+    }
+
+    out << "struct " << root.type_name << " {\n";
+    write_struct(out, root, "  ");
+    out << "};\n\n\n\n";
+
+    out << "namespace " << root.type_name << "_detail {\n";
+    write_parse(out, root);
+    out << "}\n\n\n\n";
+
+    out << "// throws the same exceptions as iconfigp::schema::validate reports\n"
+        << "[[nodiscard]] inline " << root.type_name << " parse_" << root.type_name
+        << "(const iconfigp::section& root) {\n"
+        << "  " << root.type_name << " output;\n"
+        << "  " << root.type_name << "_detail::parse_section(root, output);\n"
+        << "  return output;\n"
+        << "}\n\n";
+
+    if (!name_space.empty()) {
+      out << "}\n\n";
+    }
+
+    out << "#endif // ICONFIGP_GENERATED_" << guard << "_HPP_INCLUDED\n";
+  }
+}
+
+
+
+int main(int argc, char** argv) {
+  std::span args{argv, static_cast<size_t>(argc)};
+
+  if (args.size() < 4 || args.size() > 5) {
+    std::cerr << "usage: iconfigp-codegen <schema> <header> <name> [namespace]\n";
+    return 1;
+  }
+
+  std::ifstream input{args[1]};
+  if (!input) {
+    std::cerr << "cannot read " << args[1] << '\n';
+    return 1;
+  }
+
+  std::stringstream buffer;
+  buffer << input.rdbuf();
+  std::string content = buffer.str();
+
+  // outlives the try block, exceptions may refer to its keys
+  std::optional<iconfigp::section> description;
+
+  try {
+    description.emplace(iconfigp::parser::parse(content));
+
+    // reports invalid types, counts and defaults
+    std::ignore = iconfigp::schema{*description};
+
+    auto root = collect(*description, "", identifier(args[3]));
+
+    std::stringstream output;
+    write_header(output, root, args[1], args[3], args.size() > 4 ? args[4] : "");
+
+    std::ofstream file{args[2]};
+    file << output.str();
+    if (!file) {
+      std::cerr << "cannot write " << args[2] << '\n';
+      return 1;
+    }
+
+  } catch (const iconfigp::exception& ex) {
+    std::cerr << iconfigp::format_exception(ex, content) << std::flush;
+    return 1;
+
+  } catch (const std::exception& ex) {
+    std::cerr << args[1] << ": " << ex.what() << '\n';
+    return 1;
+  }
+
+  return 0;
+}